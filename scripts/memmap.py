@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+#______________________________________________________________________________
+#│                                                                            |
+#│ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+#│                                                                            |
+#| Permission is hereby  granted,  free of charge,  to any person obtaining a |
+#| copy of this software and associated documentation files (the "Software"), |
+#| to deal in the Software without restriction,  including without limitation |
+#| the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+#| and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+#| Software is furnished to do so, subject to the following conditions:       |
+#|                                                                            |
+#| The above  copyright notice  and this permission notice  shall be included |
+#| in all copies or substantial portions of the Software.                     |
+#|                                                                            |
+#| THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+#| OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+#| MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+#| IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+#| CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+#| OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+#| THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+#|____________________________________________________________________________|
+#|                                                                            |
+#|  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+#|                                                                            |
+#|____________________________________________________________________________|
+
+# Ram budget of a build, from the map file written by the linker.
+#
+# usage: memmap.py [-v] [--ram BYTES] application.map [other.map ...]
+#
+# The static data (.data, .bss) is grouped in stacks, kernel objects, queues, message pools,
+# framebuffer, rtos heap and the rest, and compared to the ram of the device (taken from the
+# memory configuration of the map file, 128KB for the F411 otherwise). With MEM_STATIC the task
+# stacks and the kernel objects are listed one by one, otherwise they are part of the rtos heap.
+# One report is printed per map file (product), -v also lists the symbols of each group.
+#
+# The symbols are only visible in the map when the sources are built with -fdata-sections (one
+# input section per variable), a map without them is refused.
+
+import re
+import os
+import sys
+import argparse
+
+F411_RAM = 128 * 1024
+
+# first match wins, applied to the symbol name
+GROUPS = [
+    ('main stack/heap', re.compile(r'^\._user_heap_stack$')),
+    ('task stacks',     re.compile(r'_stack$')),
+    ('kernel objects',  re.compile(r'(_tcb|_control)$')),
+    ('queues',          re.compile(r'_storage$')),
+    ('message pools',   re.compile(r'^(tft_updates|dma_requests|dma_pending|encoder_events)$')),
+    ('framebuffer',     re.compile(r'^fb_')),
+    ('rtos heap',       re.compile(r'^ucHeap$')),
+]
+
+SECTION = re.compile(r'^(?: (\.(?:data|bss|noinit)(?:\.\S+)?|COMMON)|(\._user_heap_stack))(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)(?:\s+(.*))?)?$')
+CONTINUATION = re.compile(r'^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)(?:\s+(.*))?$')
+MEMORY = re.compile(r'^(\w+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)(?:\s+\S+)?\s*$')
+
+
+def object_file(text):
+    # the object file, or "load address ..." for the sections with a copy in flash
+    if not text or text.startswith('load address'):
+        return ''
+    return text.split()[0]
+
+
+def per_symbol(section):
+    # .bss.<name> from -fdata-sections, not the plain .bss of an object file
+    return section.startswith('.') and section.count('.') >= 2 and not section.startswith('._')
+
+
+def symbol_name(section, obj):
+    if per_symbol(section):
+        name = section.split('.', 2)[2]
+        # static variables of functions get a numbered suffix
+        return re.sub(r'\.\d+$', '', name)
+    if section == '._user_heap_stack':
+        return section
+    return '%s(%s)' % (os.path.basename(obj) or '?', section)
+
+
+def parse(path):
+    ram = None
+    items = []
+    pending = None
+    in_memory = False
+    with open(path, 'r', errors='replace') as f:
+        for line in f:
+            line = line.rstrip('\n')
+            if line.startswith('Memory Configuration'):
+                in_memory = True
+                continue
+            if line.startswith('Linker script and memory map'):
+                in_memory = False
+                continue
+            if in_memory:
+                m = MEMORY.match(line)
+                if m and m.group(1).upper() in ('RAM', 'SRAM'):
+                    ram = int(m.group(3), 16)
+                continue
+
+            if pending:
+                m = CONTINUATION.match(line)
+                if m:
+                    items.append((pending, int(m.group(1), 16), int(m.group(2), 16), object_file(m.group(3))))
+                pending = None
+                continue
+            m = SECTION.match(line)
+            if not m:
+                continue
+            section = m.group(1) or m.group(2)
+            if m.group(3) is None:
+                # long section names continue on the next line
+                pending = section
+            else:
+                items.append((section, int(m.group(3), 16), int(m.group(4), 16), object_file(m.group(5))))
+
+    # only what is placed in ram and takes space
+    symbols = []
+    split = 0
+    for section, address, size, obj in items:
+        if size == 0 or not (0x20000000 <= address < 0x40000000):
+            continue
+        symbols.append((symbol_name(section, obj), size))
+        split += per_symbol(section)
+    return ram, symbols, split
+
+
+def report(path, ram, symbols, verbose):
+    groups = {name: [] for name, _ in GROUPS}
+    groups['other'] = []
+    for name, size in symbols:
+        for group, pattern in GROUPS:
+            if pattern.search(name):
+                groups[group].append((name, size))
+                break
+        else:
+            groups['other'].append((name, size))
+
+    used = sum(size for _, size in symbols)
+    print('%s' % path)
+    print('  %-18s %8s %7s' % ('group', 'bytes', '% ram'))
+    for group in [name for name, _ in GROUPS] + ['other']:
+        entries = groups[group]
+        if not entries:
+            continue
+        total = sum(size for _, size in entries)
+        print('  %-18s %8d %6.1f%%' % (group, total, total * 100.0 / ram))
+        if verbose:
+            for name, size in sorted(entries, key=lambda e: -e[1]):
+                print('      %-30s %8d' % (name, size))
+    print('  %-18s %8d %6.1f%%' % ('used', used, used * 100.0 / ram))
+    print('  %-18s %8d %6.1f%%' % ('free', ram - used, (ram - used) * 100.0 / ram))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='ram budget from linker map files')
+    parser.add_argument('maps', nargs='+', help='map file of each product')
+    parser.add_argument('--ram', type=int, help='ram size in bytes (default from the map file, else 128KB)')
+    parser.add_argument('-v', '--verbose', action='store_true', help='list the symbols of each group')
+    args = parser.parse_args()
+
+    for path in args.maps:
+        ram, symbols, split = parse(path)
+        if symbols and not split:
+            sys.exit('%s: no per-symbol data sections, build with -fdata-sections' % path)
+        report(path, args.ram or ram or F411_RAM, symbols, args.verbose)
+
+
+if __name__ == '__main__':
+    main()
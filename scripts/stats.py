@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+#______________________________________________________________________________
+#│                                                                            |
+#│ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+#│                                                                            |
+#| Permission is hereby  granted,  free of charge,  to any person obtaining a |
+#| copy of this software and associated documentation files (the "Software"), |
+#| to deal in the Software without restriction,  including without limitation |
+#| the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+#| and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+#| Software is furnished to do so, subject to the following conditions:       |
+#|                                                                            |
+#| The above  copyright notice  and this permission notice  shall be included |
+#| in all copies or substantial portions of the Software.                     |
+#|                                                                            |
+#| THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+#| OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+#| MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+#| IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+#| CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+#| OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+#| THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+#|____________________________________________________________________________|
+#|                                                                            |
+#|  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+#|                                                                            |
+#|____________________________________________________________________________|
+
+# Parser for the run time statistics printed by the stats task over ITM.
+#
+# usage: stats.py [--csv] [capture.txt]
+#
+# The capture is the text of ITM stimulus port 0 (e.g. from openocd "itm port 0 on"
+# with "tpiu config ... uart off <baud>" redirected to a file), stdin if no file is given.
+# Lines that are not statistic records (printf output) are ignored.
+# Interrupt durations are printed in cycles and in us at the --mhz core clock.
+
+import sys
+import argparse
+
+# frame pacing qualities, in the order of frame_quality_t
+QUALITY = ('full', 'reduced', 'minimal')
+
+
+class Report:
+    def __init__(self, uptime_ms, period):
+        self.uptime_ms = uptime_ms
+        self.period = period
+        self.tasks = []
+        self.queues = []
+        self.isrs = []
+        self.priority = []
+        self.heap = None
+        self.frames = None
+        self.updates = None
+        self.pacing = None
+        self.devices = []
+
+
+def parse(lines):
+    reports = []
+    report = None
+    for line in lines:
+        fields = line.split()
+        if not fields:
+            continue
+        try:
+            if fields[0] == 'S' and len(fields) == 3:
+                report = Report(int(fields[1]), int(fields[2]))
+                reports.append(report)
+            elif fields[0] == 'T' and len(fields) == 4 and report:
+                report.tasks.append((fields[1], int(fields[2]), int(fields[3])))
+            elif fields[0] == 'Q' and len(fields) == 4 and report:
+                report.queues.append((fields[1], int(fields[2]), int(fields[3])))
+            elif fields[0] == 'I' and len(fields) == 8 and report:
+                report.isrs.append((fields[1], int(fields[2]), int(fields[3]), int(fields[4]),
+                                    int(fields[5]), int(fields[6]), fields[7]))
+            elif fields[0] == 'H' and len(fields) == 3 and report:
+                report.heap = (int(fields[1]), int(fields[2]))
+            elif fields[0] == 'U' and len(fields) == 4 and report:
+                report.updates = tuple(int(f) for f in fields[1:])
+            elif fields[0] == 'D' and len(fields) == 8 and report:
+                report.devices.append((fields[1],) + tuple(int(f) for f in fields[2:]))
+            elif fields[0] == 'R' and len(fields) == 9 and report:
+                report.pacing = tuple(int(f) for f in fields[1:])
+            elif fields[0] == 'F' and len(fields) == 7 and report:
+                report.frames = tuple(int(f) for f in fields[1:])
+            elif fields[0] == 'P' and report:
+                report.priority = fields[1:]
+        except ValueError:
+            continue
+    return reports
+
+
+def print_table(reports, mhz):
+    for report in reports:
+        print('t=%.3fs period=%d cycles' % (report.uptime_ms / 1000.0, report.period))
+        print('  %-14s %7s %11s' % ('task', 'cpu %', 'stack free'))
+        for name, permille, stack in sorted(report.tasks, key=lambda t: -t[1]):
+            print('  %-14s %7.1f %11d' % (name, permille / 10.0, stack))
+        if report.queues:
+            print('  %-14s %7s %11s' % ('queue', 'peak', 'length'))
+            for name, peak, length in report.queues:
+                print('  %-14s %7d %11d' % (name, peak, length))
+        if report.heap:
+            print('  heap free %d bytes, minimum ever %d bytes' % report.heap)
+        if report.devices:
+            seconds = report.period / (mhz * 1e6) if report.period else 0.0
+            print('  %-14s %9s %9s %7s %11s %11s %7s' % ('i2c device', 'transfers', 'bytes/s', 'busy %', 'avg wait us', 'max wait us', 'misses'))
+            for address, transfers, count, busy, wait, wait_max, misses in report.devices:
+                print('  0x%-12s %9d %9.0f %7.1f %11d %11d %7d' %
+                      (address, transfers, count / seconds if seconds else 0.0, busy / (seconds * 1e4) if seconds else 0.0,
+                       wait, wait_max, misses))
+        if report.updates:
+            posted, drawn, rows = report.updates
+            print('  updates %d merged into %d frames, %d rows drawn' % (posted, drawn, rows))
+        if report.pacing:
+            frames, avg, peak, missed, over, skipped, degraded, quality = report.pacing
+            print('  pacing %d frames: %d us, max %d us, %d missed, %d over budget, %d slots skipped, quality %s (%d drops)' %
+                  (frames, avg, peak, missed, over, skipped, QUALITY[quality] if quality < len(QUALITY) else quality, degraded))
+        if report.frames:
+            frames, total, render, transfer, idle, peak = report.frames
+            overlap = (render + transfer - total) * 100.0 / total if total else 0.0
+            print('  frames %d: %.0f us (render %.0f, transfer %.0f, bus idle %.0f, overlap %.0f%%), max %.0f us' %
+                  (frames, total / mhz, render / mhz, transfer / mhz, idle / mhz, overlap, peak / mhz))
+        if report.isrs:
+            print('  %-14s %9s %9s %9s %9s %12s %-10s' %
+                  ('isr', 'count', 'avg us', 'max us', 'blocked', 'blk max us', 'blocked by'))
+            for name, count, avg, peak, blocked, blocked_max, blocked_by in report.isrs:
+                print('  %-14s %9d %9.2f %9.2f %9d %12.2f %-10s' %
+                      (name, count, avg / mhz, peak / mhz, blocked, blocked_max / mhz, blocked_by))
+        if report.priority:
+            print('  priority order: %s' % ' > '.join(report.priority))
+        print()
+
+
+def print_csv(reports, mhz):
+    print('uptime_ms,kind,name,value,limit')
+    for report in reports:
+        for name, permille, stack in report.tasks:
+            print('%d,task,%s,%.1f,%d' % (report.uptime_ms, name, permille / 10.0, stack))
+        for name, peak, length in report.queues:
+            print('%d,queue,%s,%d,%d' % (report.uptime_ms, name, peak, length))
+        if report.heap:
+            print('%d,heap,free,%d,%d' % (report.uptime_ms, report.heap[0], report.heap[1]))
+        for address, transfers, count, busy, wait, wait_max, misses in report.devices:
+            print('%d,i2c,0x%s,%d,%d' % (report.uptime_ms, address, wait, wait_max))
+        if report.updates:
+            print('%d,update,frames,%d,%d' % (report.uptime_ms, report.updates[1], report.updates[0]))
+        if report.pacing:
+            print('%d,pacing,time,%d,%d' % (report.uptime_ms, report.pacing[1], report.pacing[2]))
+            print('%d,pacing,missed,%d,%d' % (report.uptime_ms, report.pacing[3], report.pacing[0]))
+        if report.frames:
+            print('%d,frame,total,%.1f,%.1f' % (report.uptime_ms, report.frames[1] / mhz, report.frames[5] / mhz))
+            print('%d,frame,render,%.1f,' % (report.uptime_ms, report.frames[2] / mhz))
+            print('%d,frame,transfer,%.1f,' % (report.uptime_ms, report.frames[3] / mhz))
+        for name, count, avg, peak, blocked, blocked_max, blocked_by in report.isrs:
+            print('%d,isr,%s,%.2f,%.2f' % (report.uptime_ms, name, avg / mhz, peak / mhz))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='decode the stats task output')
+    parser.add_argument('capture', nargs='?', help='captured ITM text (default stdin)')
+    parser.add_argument('--csv', action='store_true', help='print csv instead of tables')
+    parser.add_argument('--mhz', type=float, default=96.0, help='core clock in MHz (default 96)')
+    args = parser.parse_args()
+
+    if args.capture:
+        with open(args.capture, 'r', errors='replace') as f:
+            reports = parse(f)
+    else:
+        reports = parse(sys.stdin)
+
+    if args.csv:
+        print_csv(reports, args.mhz)
+    else:
+        print_table(reports, args.mhz)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+#______________________________________________________________________________
+#│                                                                            |
+#│ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+#│                                                                            |
+#| Permission is hereby  granted,  free of charge,  to any person obtaining a |
+#| copy of this software and associated documentation files (the "Software"), |
+#| to deal in the Software without restriction,  including without limitation |
+#| the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+#| and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+#| Software is furnished to do so, subject to the following conditions:       |
+#|                                                                            |
+#| The above  copyright notice  and this permission notice  shall be included |
+#| in all copies or substantial portions of the Software.                     |
+#|                                                                            |
+#| THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+#| OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+#| MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+#| IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+#| CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+#| OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+#| THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+#|____________________________________________________________________________|
+#|                                                                            |
+#|  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+#|                                                                            |
+#|____________________________________________________________________________|
+
+# Decoder for the binary trace written by trace.c to ITM stimulus port 1.
+#
+# usage: trace.py [--clock HZ] [--text] [-o out.json] capture.bin
+#
+# The capture is the raw SWO byte stream (ITM packets, e.g. openocd "tpiu config internal
+# capture.bin uart off <cpu hz> <swo hz>"). The output is a Chrome trace JSON (chrome://tracing,
+# Perfetto) or a text timeline with --text. Text written to port 0 (printf) is kept as log events.
+
+import sys
+import json
+import struct
+import argparse
+
+TRACE_PORT = 1
+TEXT_PORT = 0
+TRACE_SYNC = 0xA5
+
+# event ids, keep in sync with trace.h
+EVENTS = {
+    0x0001: ('spi', 'B'),
+    0x0002: ('spi', 'E'),
+    0x0010: ('dma complete', 'i'),
+    0x0020: ('queue send', 'i'),
+    0x0021: ('queue receive', 'i'),
+    0x0030: ('draw', 'B'),
+    0x0031: ('draw', 'E'),
+    0x0040: ('records lost', 'i'),
+}
+
+QUEUES = ['tft', 'encoder', 'dma']
+DRAWS = ['rows', 'flush']
+THREADS = {'spi': 1, 'draw': 2, 'dma complete': 3, 'queue send': 4, 'queue receive': 4, 'log': 5, 'records lost': 5}
+
+
+def itm_packets(data):
+    """yields (port, payload bytes) for the software source packets of an ITM stream"""
+    i = 0
+    n = len(data)
+    while i < n:
+        header = data[i]
+        i += 1
+        if header == 0x00:
+            # synchronization: zeros terminated by 0x80
+            continue
+        if header == 0x80 or header == 0x70:
+            # end of synchronization, overflow
+            continue
+        size = header & 0x03
+        if size:
+            length = {1: 1, 2: 2, 3: 4}[size]
+            payload = data[i:i + length]
+            i += length
+            if (header & 0x04) == 0 and len(payload) == length:
+                yield header >> 3, payload
+            continue
+        # timestamps and extension packets: continuation bytes while bit 7 is set
+        if header & 0x80:
+            while i < n and data[i] & 0x80:
+                i += 1
+            i += 1
+
+
+def decode(data):
+    """returns the trace records (id, cycles, arg0, arg1) and the text lines (record index, line)"""
+    words = []
+    text = []
+    line = ''
+    for port, payload in itm_packets(data):
+        if port == TRACE_PORT and len(payload) == 4:
+            words.append(struct.unpack('<I', payload)[0])
+        elif port == TEXT_PORT:
+            for c in payload.decode('latin-1'):
+                if c == '\n':
+                    text.append((len(words), line))
+                    line = ''
+                else:
+                    line += c
+
+    records = []
+    ends = []
+    i = 0
+    while i + 4 <= len(words):
+        if (words[i] >> 24) != TRACE_SYNC:
+            # lost words, resynchronize on the next record header
+            i += 1
+            continue
+        records.append((words[i] & 0xFFFF, words[i + 1], words[i + 2], words[i + 3]))
+        i += 4
+        ends.append(i)
+
+    # the text lines refer to the last record complete before them
+    text = [(sum(1 for end in ends if end <= index) - 1, line) for index, line in text]
+    return records, text
+
+
+def timeline(records, clock):
+    """converts the 32 bit cycle counter to a monotonic time in us"""
+    events = []
+    offset = 0
+    previous = None
+    for event, cycles, arg0, arg1 in records:
+        if previous is not None and cycles < previous and previous - cycles > 0x80000000:
+            offset += 1 << 32
+        previous = cycles
+        events.append(((offset + cycles) * 1e6 / clock, event, arg0, arg1))
+    return events
+
+
+def event_name(event, arg0, arg1):
+    name, phase = EVENTS.get(event, ('event 0x%04x' % event, 'i'))
+    args = {}
+    if name == 'spi':
+        name = 'spi%d' % arg0
+        args = {'bytes': arg1}
+    elif name == 'draw':
+        name = DRAWS[arg0] if arg0 < len(DRAWS) else 'draw %d' % arg0
+    elif name.startswith('queue'):
+        queue = QUEUES[arg0] if arg0 < len(QUEUES) else str(arg0)
+        name = '%s %s' % (name, queue)
+        args = {'type': arg1}
+    elif name == 'dma complete':
+        args = {'id': arg0, 'status': arg1}
+    elif name == 'records lost':
+        args = {'records': arg0}
+    else:
+        args = {'arg0': arg0, 'arg1': arg1}
+    return name, phase, args
+
+
+def chrome_trace(events, text):
+    trace = []
+    for us, event, arg0, arg1 in events:
+        name, phase, args = event_name(event, arg0, arg1)
+        category = EVENTS.get(event, ('event', 'i'))[0]
+        entry = {'name': name, 'cat': category, 'ph': phase, 'ts': us, 'pid': 1, 'tid': THREADS.get(category, 6), 'args': args}
+        if phase == 'i':
+            entry['s'] = 't'
+        trace.append(entry)
+    for index, line in text:
+        # text has no time stamp of its own, it is placed at the preceding trace record
+        us = events[min(max(index, 0), len(events) - 1)][0] if events else 0
+        trace.append({'name': line, 'cat': 'log', 'ph': 'i', 's': 't', 'ts': us, 'pid': 1, 'tid': THREADS['log']})
+    return {'traceEvents': trace, 'displayTimeUnit': 'ns'}
+
+
+def print_text(events):
+    depth = {}
+    for us, event, arg0, arg1 in events:
+        name, phase, args = event_name(event, arg0, arg1)
+        if phase == 'E':
+            depth[name] = depth.get(name, 1) - 1
+        indent = '  ' * depth.get(name, 0)
+        arguments = ' '.join('%s=%s' % (k, v) for k, v in args.items())
+        print('%12.3f us  %s%s %s %s' % (us, indent, {'B': 'begin', 'E': 'end', 'i': '-'}[phase], name, arguments))
+        if phase == 'B':
+            depth[name] = depth.get(name, 0) + 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description='decode the binary ITM trace')
+    parser.add_argument('capture', help='raw SWO capture')
+    parser.add_argument('--clock', type=float, default=96e6, help='cpu clock in Hz (default 96MHz)')
+    parser.add_argument('--text', action='store_true', help='print a text timeline instead of json')
+    parser.add_argument('-o', '--output', help='json output file (default stdout)')
+    args = parser.parse_args()
+
+    with open(args.capture, 'rb') as f:
+        records, text = decode(f.read())
+    events = timeline(records, args.clock)
+
+    if args.text:
+        print_text(events)
+        return
+
+    output = open(args.output, 'w') if args.output else sys.stdout
+    json.dump(chrome_trace(events, text), output, indent=1)
+    output.write('\n')
+    if args.output:
+        output.close()
+
+
+if __name__ == '__main__':
+    main()
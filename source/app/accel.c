@@ -0,0 +1,80 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stdint.h"
+#include "accel.h"
+
+void accel_init(accel_t *accel, const accel_stage_t *curve, uint8_t stages)
+{
+    accel->curve = curve;
+    accel->stages = stages;
+    accel_reset(accel);
+}
+
+void accel_reset(accel_t *accel)
+{
+    accel->direction = 0;
+    accel->last_ms = 0;
+    accel->rate = 0;
+}
+
+static uint16_t accel_gain(const accel_t *accel)
+{
+    uint16_t gain = 1;
+
+    for (uint8_t i = 0; i < accel->stages; i++) {
+        if (accel->rate >= accel->curve[i].rate) {
+            gain = accel->curve[i].gain;
+        }
+    }
+    return gain;
+}
+
+int32_t accel_update(accel_t *accel, int32_t detents, uint32_t now_ms)
+{
+    int8_t direction = (detents > 0) ? 1 : -1;
+    uint32_t count = (detents > 0) ? detents : -detents;
+    uint32_t elapsed = now_ms - accel->last_ms;
+
+    if (detents == 0) {
+        return 0;
+    }
+
+    /* a pause or a change of direction starts again at the slowest stage */
+    if (direction != accel->direction || elapsed > ACCEL_IDLE_MS) {
+        accel->rate = 0;
+    }
+    else {
+        uint32_t rate = count * 1000 / ((elapsed > 0) ? elapsed : 1);
+        accel->rate = (accel->rate + rate) / 2;
+    }
+
+    accel->direction = direction;
+    accel->last_ms = now_ms;
+
+    return direction * (int32_t)(count * accel_gain(accel));
+}
@@ -0,0 +1,52 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* rotary encoder acceleration, plain C without rtos or hardware dependencies
+   the detent rate is estimated from the timestamps of the steps and selects the gain of the
+   curve: the last stage whose rate is reached applies */
+#define ACCEL_IDLE_MS       250
+
+typedef struct accel_stage_t {
+    uint16_t rate;          /* detents per second needed for the stage */
+    uint16_t gain;          /* steps emitted per detent */
+} accel_stage_t;
+
+typedef struct accel_t {
+    const accel_stage_t *curve;
+    uint8_t stages;
+    int8_t direction;
+    uint32_t last_ms;
+    uint32_t rate;          /* detents per second, smoothed */
+} accel_t;
+
+void accel_init(accel_t *accel, const accel_stage_t *curve, uint8_t stages);
+void accel_reset(accel_t *accel);
+
+/* feed the detents counted at now_ms (signed), returns the accelerated steps */
+int32_t accel_update(accel_t *accel, int32_t detents, uint32_t now_ms);
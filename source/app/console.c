@@ -0,0 +1,180 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "stdarg.h"
+#include "string.h"
+#include "task.h"
+#include "semphr.h"
+#include "mem.h"
+#include "gpio.h"
+#include "st7735.h"
+#include "panel.h"
+#include "latency.h"
+#include "fb.h"
+#include "console.h"
+#include "printf.h"
+
+extern const uint8_t u8x8_font_8x13B_1x2_f[];
+
+/* ring of text lines, head is the line written at the moment */
+static struct {
+    char lines[CONSOLE_ROWS][CONSOLE_COLUMNS];
+    uint8_t head;
+    uint8_t column;
+    uint8_t new_line;
+} console_buffer;
+
+/* lines as they are on the display */
+static char console_rendered[CONSOLE_ROWS][CONSOLE_COLUMNS + 1];
+
+static console_config_t console_config;
+static SemaphoreHandle_t console_lock = NULL;
+MEM_MUTEX(console_lock)
+static TaskHandle_t console_task = NULL;
+
+static void console_next_line()
+{
+    console_buffer.head = (console_buffer.head + 1) % CONSOLE_ROWS;
+    console_buffer.column = 0;
+    memset(console_buffer.lines[console_buffer.head], ' ', CONSOLE_COLUMNS);
+}
+
+static void console_put(char c)
+{
+    switch (c) {
+        case '\n':
+            /* the new line is started with the next character, the last line stays visible */
+            console_buffer.new_line = 1;
+            break;
+
+        case '\r':
+            console_buffer.column = 0;
+            break;
+
+        default:
+            if (console_buffer.new_line || console_buffer.column >= CONSOLE_COLUMNS) {
+                console_buffer.new_line = 0;
+                console_next_line();
+            }
+            console_buffer.lines[console_buffer.head][console_buffer.column++] = c;
+            break;
+    }
+}
+
+static void console_flush()
+{
+    char lines[CONSOLE_ROWS][CONSOLE_COLUMNS + 1];
+    const uint8_t first = CONSOLE_ROWS - console_config.rows;
+
+    /* take a snapshot of the lines shown, oldest line first */
+    xSemaphoreTake(console_lock, portMAX_DELAY);
+    for (uint8_t i = 0; i < console_config.rows; i++) {
+        memcpy(lines[i], console_buffer.lines[(console_buffer.head + 1 + first + i) % CONSOLE_ROWS], CONSOLE_COLUMNS);
+        lines[i][CONSOLE_COLUMNS] = 0;
+    }
+    xSemaphoreGive(console_lock);
+
+    /* draw only the lines that changed since the last flush, they go out in one frame */
+    uint8_t changed = 0;
+    fb_lock();
+    for (uint8_t i = 0; i < console_config.rows; i++) {
+        if (memcmp(lines[i], console_rendered[i], CONSOLE_COLUMNS + 1) != 0) {
+            fb_draw_string(u8x8_font_8x13B_1x2_f, console_config.x, console_config.y + i*16, console_config.fg, console_config.bg, lines[i]);
+            memcpy(console_rendered[i], lines[i], CONSOLE_COLUMNS + 1);
+            changed = 1;
+        }
+    }
+    if (changed) {
+        fb_flush();
+    }
+    fb_unlock();
+}
+
+void console_init(const console_config_t *config)
+{
+    console_config = *config;
+    if (console_config.rows == 0 || console_config.rows > CONSOLE_ROWS) {
+        console_config.rows = CONSOLE_ROWS;
+    }
+    console_lock = MEM_MUTEX_CREATE(console_lock);
+
+    memset(console_buffer.lines, ' ', sizeof(console_buffer.lines));
+    console_buffer.head = CONSOLE_ROWS - 1;
+    console_buffer.column = 0;
+    console_buffer.new_line = 0;
+
+    /* force a complete draw on the first flush */
+    memset(console_rendered, 0, sizeof(console_rendered));
+}
+
+void console_run(void *pvParameters)
+{
+    (void)pvParameters;
+
+    console_task = xTaskGetCurrentTaskHandle();
+
+    for (;;) {
+        console_flush();
+
+        /* everything written in the meantime is collected in a single flush */
+        vTaskDelay(console_config.period_ms / portTICK_PERIOD_MS);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+void console_write(const char *txt, uint16_t length)
+{
+    xSemaphoreTake(console_lock, portMAX_DELAY);
+    for (uint16_t i = 0; i < length; i++) {
+        console_put(txt[i]);
+    }
+    xSemaphoreGive(console_lock);
+
+    if (console_task != NULL) {
+        xTaskNotifyGive(console_task);
+    }
+}
+
+int console_printf(const char *format, ...)
+{
+    char txt[CONSOLE_ROWS * CONSOLE_COLUMNS + 1];
+    va_list va;
+
+    va_start(va, format);
+    int length = vsnprintf(txt, sizeof(txt), format, va);
+    va_end(va);
+
+    if (length > (int)(sizeof(txt) - 1)) {
+        length = sizeof(txt) - 1;
+    }
+    if (length > 0) {
+        console_write(txt, length);
+    }
+    return length;
+}
@@ -0,0 +1,50 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* size of the console (characters of the 8x16 font) */
+#define CONSOLE_ROWS        6
+#define CONSOLE_COLUMNS     16
+
+/* console output location in the framebuffer, newest lines shown (up to CONSOLE_ROWS),
+   colors as palette indexes and flush rate */
+typedef struct console_config_t {
+    uint8_t x;
+    uint8_t y;
+    uint8_t rows;
+    fb_color_t fg;
+    fb_color_t bg;
+    uint16_t period_ms;
+} console_config_t;
+
+void console_init(const console_config_t *config);
+void console_run(void *pvParameters);
+
+/* buffered output, never blocks on the display */
+void console_write(const char *txt, uint16_t length);
+int console_printf(const char *format, ...);
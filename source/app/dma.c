@@ -21,7 +21,7 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 23.Jul.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
@@ -29,15 +29,46 @@
 #include "stm32rtos.h"
 #include "string.h"
 #include "queue.h"
+#include "task.h"
+#include "trace.h"
+#include "mem.h"
+#include "pool.h"
+#include "sched.h"
 #include "dma.h"
 #include "i2c.h"
+#include "system.h"
+#include "printf.h"
+#include "stats.h"
 
 /* Queue used to communicate dma messages. */
 QueueHandle_t dma_request_queue;
-QueueHandle_t dma_response_queue;
+MEM_QUEUE(dma_request_queue, DMA_REQUEST_QUEUE_LENGTH, sizeof(dma_request_event_t *))
 
-/* DMA buffers */
-static dma_buffer_t dma_tx_buffer, dma_rx_buffer;
+/* the requests passed by pointer through the queue */
+static dma_request_event_t dma_requests[DMA_REQUEST_POOL];
+static pool_t dma_pool;
+
+/* requests waiting for the bus, indexed by the scheduler slot */
+static sched_t dma_sched;
+static dma_request_event_t *dma_pending[SCHED_SLOTS];
+
+/* request in progress, completed from the interrupt handlers */
+static dma_request_event_t *dma_current;
+static TaskHandle_t dma_task = NULL;
+static uint32_t dma_request_id = 0;
+
+/* read to be started with a repeated start after the write (write_read request) */
+static volatile uint8_t dma_restart_read = 0;
+
+/* result of the request in progress */
+static volatile dma_response_status dma_current_status;
+static volatile uint16_t dma_current_length;
+static volatile i2c_status_t dma_i2c_status;
+
+/* set while the interrupt handlers own the transfer, the first completion (or a timeout) wins */
+static volatile uint8_t dma_active = 0;
+
+static void dma_i2c_handler(i2c_status_t status);
 
 void dma_init()
 {
@@ -84,43 +115,115 @@ void dma_init()
     MODIFY_REG(DMA1_Stream0->CR, DMA_SxCR_TCIE_Msk, DMA_SxCR_TCIE);
     MODIFY_REG(DMA1_Stream1->CR, DMA_SxCR_TCIE_Msk, DMA_SxCR_TCIE);
 
-    /* create the dma request/response queues */
-    dma_request_queue  = xQueueCreate(1, sizeof(dma_request_event_t));
-    dma_response_queue = xQueueCreate(1, sizeof(dma_response_event_t));
+    /* transfers that end on the i2c side (probe, NACK, bus error) */
+    i2c_set_handler(dma_i2c_handler);
+
+    /* bus scheduler */
+    sched_init(&dma_sched, DMA_I2C_BUS_HZ);
+
+    /* create the dma request pool and queue */
+    pool_init(&dma_pool, dma_requests, sizeof(dma_request_event_t), DMA_REQUEST_POOL);
+    dma_request_queue = MEM_QUEUE_CREATE(dma_request_queue, DMA_REQUEST_QUEUE_LENGTH, sizeof(dma_request_event_t *));
+}
+
+static void dma_complete_from_isr(dma_response_status status, uint16_t length)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (!dma_active) {
+        return;
+    }
+    dma_active = 0;
+    TRACE_DMA_COMPLETE(dma_current->id, status);
+
+    dma_current_status = status;
+    dma_current_length = length;
+
+    /* hand the response to the caller unless the dma task still has to finish the request */
+    if (dma_current->type != dma_request_type_i2c_write_poll) {
+        if (dma_current->response != NULL) {
+            dma_current->response->id = dma_current->id;
+            dma_current->response->status = status;
+            dma_current->response->length = length;
+        }
+        if (dma_current->caller != NULL) {
+            xTaskNotifyFromISR(dma_current->caller, dma_current->id, eSetValueWithOverwrite, &woken);
+        }
+    }
+
+    /* let the dma task continue with the next request */
+    vTaskNotifyGiveFromISR(dma_task, &woken);
+
+    portYIELD_FROM_ISR(woken);
 }
 
 void dma_isr_rx_handler()
 {
-    dma_response_event_t res_event;
-    res_event.status = (DMA1->LISR & (DMA_LISR_FEIF0_Msk | DMA_LISR_DMEIF0_Msk | DMA_LISR_TEIF0_Msk)) ? dma_request_status_error : dma_request_status_success;
+    dma_response_status status = (DMA1->LISR & (DMA_LISR_FEIF0_Msk | DMA_LISR_DMEIF0_Msk | DMA_LISR_TEIF0_Msk)) ? dma_request_status_error : dma_request_status_success;
 
     /* clear the interupt register and stop the DMA */
     SET_BIT(DMA1->LIFCR, DMA_LIFCR_CFEIF0_Msk | DMA_LIFCR_CDMEIF0_Msk | DMA_LIFCR_CTEIF0_Msk | DMA_LIFCR_CHTIF0_Msk | DMA_LIFCR_CTCIF0_Msk);
     MODIFY_REG(DMA1_Stream0->CR, DMA_SxCR_EN_Msk, 0);
 
+    /* a stream disabled by an abort also ends up here */
+    if (!dma_active) {
+        return;
+    }
+
     /* generate a stop condition */
     i2c_stop();
 
-    /* create the response event */
-    memcpy(res_event.buffer, dma_rx_buffer.buffer, dma_rx_buffer.length);
-    res_event.length = dma_rx_buffer.length;
-
-    xQueueSendToBackFromISR(dma_response_queue, &res_event, (TickType_t) 0);
+    /* the data is already in the buffer of the caller */
+    dma_complete_from_isr(status, dma_current->rx_length - DMA1_Stream0->NDTR);
 }
 
 void dma_isr_tx_handler()
 {
-    dma_response_event_t res_event;
-    res_event.status = (DMA1->LISR & (DMA_LISR_FEIF1_Msk | DMA_LISR_DMEIF1_Msk | DMA_LISR_TEIF1_Msk)) ? dma_request_status_error : dma_request_status_success;
+    dma_response_status status = (DMA1->LISR & (DMA_LISR_FEIF1_Msk | DMA_LISR_DMEIF1_Msk | DMA_LISR_TEIF1_Msk)) ? dma_request_status_error : dma_request_status_success;
 
     /* clear the interupt register and stop the DMA */
     SET_BIT(DMA1->LIFCR, DMA_LIFCR_CFEIF1_Msk | DMA_LIFCR_CDMEIF1_Msk | DMA_LIFCR_CTEIF1_Msk | DMA_LIFCR_CHTIF1_Msk | DMA_LIFCR_CTCIF1_Msk);
     MODIFY_REG(DMA1_Stream1->CR, DMA_SxCR_EN_Msk, 0);
 
+    /* a stream disabled by an abort also ends up here */
+    if (!dma_active) {
+        return;
+    }
+
+    /* continue with the read part of a write_read request, the response comes from the rx handler */
+    if (dma_restart_read) {
+        dma_restart_read = 0;
+        if (status == dma_request_status_success) {
+            i2c_restart_read(dma_current->address, dma_current->rx_length);
+            return;
+        }
+
+        /* the read part is dropped, disarm the rx stream */
+        MODIFY_REG(DMA1_Stream0->CR, DMA_SxCR_EN_Msk, 0);
+    }
+
     /* generate a stop condition */
     i2c_stop();
 
-    xQueueSendToBackFromISR(dma_response_queue, &res_event, (TickType_t) 0);
+    dma_complete_from_isr(status, dma_current->tx_length - DMA1_Stream1->NDTR);
+}
+
+static void dma_disable_streams()
+{
+    dma_restart_read = 0;
+    MODIFY_REG(DMA1_Stream0->CR, DMA_SxCR_EN_Msk, 0);
+    MODIFY_REG(DMA1_Stream1->CR, DMA_SxCR_EN_Msk, 0);
+}
+
+static void dma_i2c_handler(i2c_status_t status)
+{
+    /* the data phase did not complete, the streams are stopped before reporting */
+    if (status != i2c_status_success) {
+        dma_disable_streams();
+    }
+
+    dma_i2c_status = status;
+    dma_complete_from_isr((status == i2c_status_success) ? dma_request_status_success : dma_request_status_error, 0);
 }
 
 static void i2c_rx(uint8_t *buffer, uint16_t size)
@@ -134,7 +237,7 @@ static void i2c_rx(uint8_t *buffer, uint16_t size)
     MODIFY_REG(DMA1_Stream0->CR, DMA_SxCR_EN_Msk, DMA_SxCR_EN);
 }
 
-static void i2c_tx(uint8_t *buffer, uint16_t size)
+static void i2c_tx(const uint8_t *buffer, uint16_t size)
 {
     /* configure the DMA for transmission */
     DMA1_Stream1->PAR  = &(I2C1->DR);
@@ -145,27 +248,305 @@ static void i2c_tx(uint8_t *buffer, uint16_t size)
     MODIFY_REG(DMA1_Stream1->CR, DMA_SxCR_EN_Msk, DMA_SxCR_EN);
 }
 
+static uint8_t dma_wait_complete(uint16_t length)
+{
+    uint8_t expired = 0;
+
+    /* the dma task sleeps for the whole transfer, the interrupts do all the work */
+    if (ulTaskNotifyTake(pdTRUE, DMA_TRANSFER_TIMEOUT_MS(length) / portTICK_PERIOD_MS) != 0) {
+        return 1;
+    }
+
+    /* the interrupt handlers may still complete the transfer while it is aborted */
+    taskENTER_CRITICAL();
+    if (dma_active) {
+        dma_active = 0;
+        expired = 1;
+        dma_disable_streams();
+        i2c_abort();
+    }
+    taskEXIT_CRITICAL();
+
+    if (!expired) {
+        ulTaskNotifyTake(pdTRUE, 0);
+        return 1;
+    }
+
+    dma_current_status = dma_request_status_error;
+    dma_current_length = 0;
+    dma_i2c_status = i2c_status_error;
+    return 0;
+}
+
+static dma_response_status dma_poll(uint8_t address)
+{
+    TickType_t start = xTaskGetTickCount();
+
+    /* the device does not acknowledge its address until the internal write cycle is over */
+    for (;;) {
+        dma_active = 1;
+        i2c_start_probe(address);
+        dma_wait_complete(0);
+
+        if (dma_i2c_status == i2c_status_success) {
+            return dma_request_status_success;
+        }
+        if (dma_i2c_status != i2c_status_nack) {
+            return dma_request_status_error;
+        }
+        if ((xTaskGetTickCount() - start) > (DMA_POLL_TIMEOUT_MS / portTICK_PERIOD_MS)) {
+            return dma_request_status_error;
+        }
+
+        /* the write cycle takes a few ms, the probes are spaced instead of flooding the bus */
+        vTaskDelay((DMA_POLL_INTERVAL_MS + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+    }
+}
+
+static void dma_respond(dma_request_event_t *req_event)
+{
+    /* the caller may give up waiting at any time (see dma_detach) */
+    taskENTER_CRITICAL();
+    if (req_event->response != NULL) {
+        req_event->response->id = req_event->id;
+        req_event->response->status = dma_current_status;
+        req_event->response->length = dma_current_length;
+    }
+    if (req_event->caller != NULL) {
+        xTaskNotify(req_event->caller, req_event->id, eSetValueWithOverwrite);
+    }
+    taskEXIT_CRITICAL();
+}
+
+static void dma_execute(dma_request_event_t *req_event)
+{
+    uint8_t completed;
+    uint16_t length = 0;
+
+    dma_current = req_event;
+    dma_i2c_status = i2c_status_success;
+    dma_active = 1;
+    switch (req_event->type) {
+        case dma_request_type_i2c_write:
+        case dma_request_type_i2c_write_poll:
+            i2c_tx(req_event->tx_buffer, req_event->tx_length);
+            i2c_start_write(req_event->address);
+            length = req_event->tx_length;
+            break;
+        case dma_request_type_i2c_read:
+            i2c_rx(req_event->rx_buffer, req_event->rx_length);
+            i2c_start_read(req_event->address, req_event->rx_length);
+            length = req_event->rx_length;
+            break;
+        case dma_request_type_i2c_write_read:
+            /* the rx stream is armed up front, it only runs once the read phase starts */
+            i2c_rx(req_event->rx_buffer, req_event->rx_length);
+            dma_restart_read = 1;
+
+            i2c_tx(req_event->tx_buffer, req_event->tx_length);
+            i2c_start_write(req_event->address);
+            length = req_event->tx_length + req_event->rx_length;
+            break;
+    }
+
+    /* one transfer at a time on the bus, wait for the interrupt handlers to complete it */
+    completed = dma_wait_complete(length);
+
+    /* a write_poll is only complete once the device is ready again */
+    if (completed && req_event->type == dma_request_type_i2c_write_poll && dma_current_status == dma_request_status_success) {
+        length = dma_current_length;
+        dma_current_status = dma_poll(req_event->address);
+        dma_current_length = length;
+    }
+
+    /* after a bus error or a timeout the bus is recovered before the next request */
+    if (dma_i2c_status == i2c_status_error) {
+        i2c_recover();
+    }
+
+    /* responses not already sent from the interrupt handlers */
+    if (!completed || req_event->type == dma_request_type_i2c_write_poll) {
+        dma_respond(req_event);
+    }
+}
+
+static uint32_t dma_now_us()
+{
+    return xTaskGetTickCount() * portTICK_PERIOD_MS * 1000;
+}
+
+static uint16_t dma_request_bytes(const dma_request_event_t *request)
+{
+    switch (request->type) {
+        case dma_request_type_i2c_read:
+            return request->rx_length;
+        case dma_request_type_i2c_write_read:
+            return request->tx_length + request->rx_length + 1;
+        default:
+            return request->tx_length;
+    }
+}
+
+static void dma_schedule(dma_request_event_t *request)
+{
+    int8_t slot = sched_push(&dma_sched, request->address, request->priority, request->deadline_us, dma_request_bytes(request), dma_now_us());
+
+    /* the queue is only read while a slot is free, a request that still finds none goes back to
+       the front of the queue: besides the slots the pool holds at most a full queue, there is room */
+    if (slot < 0) {
+        xQueueSendToFront(dma_request_queue, &request, 0);
+        return;
+    }
+    dma_pending[slot] = request;
+}
+
 void dma_run(void *pvParameters)
 {
     (void)pvParameters;
 
+    dma_task = xTaskGetCurrentTaskHandle();
+
     for (;;) {
-        dma_request_event_t req_event;
-        if (xQueueReceive(dma_request_queue, &req_event, portMAX_DELAY) == pdPASS) {
-            switch (req_event.type) {
-                case dma_request_type_i2c_write:
-                    dma_tx_buffer.length = req_event.length;
-                    memcpy(dma_tx_buffer.buffer, req_event.buffer, dma_tx_buffer.length);
-                    i2c_tx(dma_tx_buffer.buffer, dma_tx_buffer.length);
-                    i2c_start_write(req_event.address);
-                    break;
-                case dma_request_type_i2c_read:
-                    dma_rx_buffer.length = req_event.length;
-                    memset(dma_rx_buffer.buffer, 0, dma_rx_buffer.length);
-                    i2c_rx(dma_rx_buffer.buffer, dma_rx_buffer.length);
-                    i2c_start_read(req_event.address, dma_rx_buffer.length);
-                    break;
-            }
+        dma_request_event_t *req_event;
+        int8_t slot;
+
+        /* collect the new requests, block only if there is nothing to schedule */
+        while (!sched_full(&dma_sched) &&
+               xQueueReceive(dma_request_queue, &req_event, sched_queued(&dma_sched) ? 0 : portMAX_DELAY) == pdPASS) {
+            TRACE_QUEUE_RECEIVE(trace_queue_dma, req_event->type);
+            dma_schedule(req_event);
+        }
+
+        slot = sched_pop(&dma_sched, dma_now_us());
+        if (slot < 0) {
+            continue;
+        }
+
+        req_event = dma_pending[slot];
+        dma_execute(req_event);
+
+        taskENTER_CRITICAL();
+        sched_done(&dma_sched, slot, dma_now_us());
+        taskEXIT_CRITICAL();
+
+        /* a follow up transfer competes again with the waiting requests, the others go back to the pool */
+        if (req_event->complete != NULL && req_event->complete(req_event, dma_current_status) == pdTRUE) {
+            dma_schedule(req_event);
+        }
+        else {
+            pool_free(&dma_pool, req_event);
+        }
+    }
+}
+
+static uint32_t dma_next_id()
+{
+    uint32_t id;
+
+    taskENTER_CRITICAL();
+    if (++dma_request_id == 0) {
+        dma_request_id = 1;
+    }
+    id = dma_request_id;
+    taskEXIT_CRITICAL();
+
+    return id;
+}
+
+/* the single copy of the request, the queue and the scheduler pass the pool block */
+static void dma_send(const dma_request_event_t *request)
+{
+    dma_request_event_t *block = pool_alloc(&dma_pool, portMAX_DELAY);
+
+    *block = *request;
+    TRACE_QUEUE_SEND(trace_queue_dma, block->type);
+    stats_queue_send(dma_request_queue);
+    xQueueSendToBack(dma_request_queue, &block, portMAX_DELAY);
+}
+
+uint32_t dma_submit(dma_request_event_t *request, dma_response_event_t *response)
+{
+    request->id = dma_next_id();
+    request->caller = xTaskGetCurrentTaskHandle();
+    request->response = response;
+    request->complete = NULL;
+    dma_send(request);
+
+    return request->id;
+}
+
+/* the request goes on without a caller: wherever its block is (queue, scheduler or on the bus)
+   the response and the notification are dropped. free blocks are linked through the id, the
+   fields cleared here are not used by the pool */
+static void dma_detach(uint32_t id)
+{
+    taskENTER_CRITICAL();
+    for (uint16_t i = 0; i < DMA_REQUEST_POOL; i++) {
+        if (dma_requests[i].id == id) {
+            dma_requests[i].response = NULL;
+            dma_requests[i].caller = NULL;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+BaseType_t dma_wait(uint32_t id, TickType_t timeout)
+{
+    uint32_t value;
+
+    /* notifications of older requests (e.g. after a timeout) are skipped */
+    do {
+        if (xTaskNotifyWait(0, 0xFFFFFFFF, &value, timeout) != pdPASS) {
+            dma_detach(id);
+            return pdFALSE;
+        }
+    } while (value != id);
+
+    return pdTRUE;
+}
+
+dma_response_status dma_transfer(dma_request_event_t *request, dma_response_event_t *response)
+{
+    uint32_t id = dma_submit(request, response);
+    if (dma_wait(id, portMAX_DELAY) != pdTRUE) {
+        return dma_request_status_error;
+    }
+    return response->status;
+}
+
+void dma_post(dma_request_event_t *request)
+{
+    request->id = dma_next_id();
+    request->caller = NULL;
+    request->response = NULL;
+    dma_send(request);
+}
+
+void dma_report()
+{
+    char txt[80];
+    sched_stats_t stats[SCHED_DEVICES];
+    uint8_t devices;
+
+    /* the counters restart with each report, the addresses stay */
+    taskENTER_CRITICAL();
+    devices = dma_sched.devices;
+    for (uint8_t i = 0; i < devices; i++) {
+        stats[i] = dma_sched.stats[i];
+        memset(&dma_sched.stats[i], 0, sizeof(sched_stats_t));
+        dma_sched.stats[i].address = stats[i].address;
+    }
+    taskEXIT_CRITICAL();
+
+    for (uint8_t i = 0; i < devices; i++) {
+        sched_stats_t *device = &stats[i];
+        if (device->transfers == 0) {
+            continue;
         }
+        int length = snprintf(txt, sizeof(txt), "D %02X %lu %lu %lu %lu %lu %lu\n", (unsigned)device->address,
+                              (unsigned long)device->transfers, (unsigned long)device->bytes, (unsigned long)device->busy_us,
+                              (unsigned long)(device->wait_us / device->transfers), (unsigned long)device->wait_max_us,
+                              (unsigned long)device->deadline_misses);
+        _write(0, txt, length);
     }
 }
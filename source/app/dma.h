@@ -21,7 +21,7 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 23.Jul.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
@@ -30,35 +30,90 @@
 typedef enum {
     dma_request_type_i2c_write,
     dma_request_type_i2c_read,
+    dma_request_type_i2c_write_read,
+    dma_request_type_i2c_write_poll,
 } dma_request_type;
 
+/* scheduling class of a request, lower values pre-empt higher ones at transfer boundaries */
+typedef enum {
+    dma_priority_critical,
+    dma_priority_normal,
+    dma_priority_bulk,
+} dma_priority_t;
+
 typedef enum {
     dma_request_status_success,
     dma_request_status_error,
 } dma_response_status;
 
-typedef struct dma_request_event_t {
-    dma_request_type type;
-    uint8_t address;
-    uint8_t buffer[16];
-    uint8_t length;
-} dma_request_event_t;
+/* number of requests that can be queued for the dma task */
+#define DMA_REQUEST_QUEUE_LENGTH    8
+
+/* requests in circulation: the queued ones plus the ones held by the scheduler */
+#define DMA_REQUEST_POOL            (DMA_REQUEST_QUEUE_LENGTH + SCHED_SLOTS)
+
+/* bus clock, used by the scheduler to estimate the transfer times */
+#define DMA_I2C_BUS_HZ              400000
+
+/* maximum time a write_poll request waits for the device to acknowledge again */
+#define DMA_POLL_TIMEOUT_MS         20
+
+/* spacing of the acknowledge probes of a write_poll request, at least a tick */
+#define DMA_POLL_INTERVAL_MS        1
+
+/* transfer timeout, about 44 bytes per ms at 400kHz plus margin for the start and address phase */
+#define DMA_TRANSFER_TIMEOUT_MS(length)     (10 + (length) / 32)
 
+/* completion descriptor, written by the interrupt handlers */
 typedef struct dma_response_event_t {
+    uint32_t id;
     dma_response_status status;
-    uint8_t buffer[16];
-    uint8_t length;
+    uint16_t length;
 } dma_response_event_t;
 
-typedef struct dma_buffer_t {
-    uint8_t buffer[16];
-    uint8_t length;
-} dma_buffer_t;
+/* the request is copied once into a pool block at submission and passed by pointer from
+   there on, the buffers belong to the caller and are used by the DMA directly, they must
+   stay valid until the request is completed */
+typedef struct dma_request_event_t dma_request_event_t;
+struct dma_request_event_t {
+    uint32_t id;
+    TaskHandle_t caller;
+    dma_response_event_t *response;
+
+    /* called by the dma task when the request is done, returns pdTRUE if the request was
+       filled with a follow up transfer that is scheduled with the same priority */
+    BaseType_t (*complete)(dma_request_event_t *request, dma_response_status status);
+
+    /* scheduling, the deadline is relative to the submission (0 for none) */
+    dma_priority_t priority;
+    uint32_t deadline_us;
+
+    dma_request_type type;
+    uint8_t address;
+    const uint8_t *tx_buffer;
+    uint16_t tx_length;
+    uint8_t *rx_buffer;
+    uint16_t rx_length;
+};
 
 extern QueueHandle_t dma_request_queue;
-extern QueueHandle_t dma_response_queue;
 
 void dma_init();
+
+/* request submission, the caller is notified with the request id on completion. after a wait
+   that timed out the response is no longer written, the request itself still runs: its tx and
+   rx buffers must stay valid until it is done */
+uint32_t dma_submit(dma_request_event_t *request, dma_response_event_t *response);
+BaseType_t dma_wait(uint32_t id, TickType_t timeout);
+dma_response_status dma_transfer(dma_request_event_t *request, dma_response_event_t *response);
+
+/* request submission without caller notification, completed by the request callback */
+void dma_post(dma_request_event_t *request);
+
+/* prints the bus statistics of each device since the last call over ITM (times in us):
+       D <address> <transfers> <bytes> <busy> <avg wait> <max wait> <deadline misses> */
+void dma_report();
+
 void dma_isr_rx_handler();
 void dma_isr_tx_handler();
 void dma_run(void *pvParameters);
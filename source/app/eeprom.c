@@ -0,0 +1,220 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "string.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "mem.h"
+#include "sched.h"
+#include "dma.h"
+#include "eeprom.h"
+
+/* ram copy of the device, valid below eeprom_loaded */
+static uint8_t eeprom_mirror[EEPROM_SIZE];
+static uint16_t eeprom_loaded = 0;
+static SemaphoreHandle_t eeprom_lock = NULL;
+MEM_MUTEX(eeprom_lock)
+
+/* write combining: one bit per page of the mirror that is not yet on the device, the pages
+   are written whole so any number of small writes to one page cost a single write cycle */
+static uint32_t eeprom_dirty = 0;
+static uint8_t eeprom_busy = 0;
+static uint16_t eeprom_writing = 0;
+static uint8_t eeprom_retries = 0;
+static uint32_t eeprom_errors = 0;
+
+/* page write in flight, the first byte is the word address */
+static uint8_t eeprom_page[1 + EEPROM_PAGE_SIZE];
+static dma_request_event_t eeprom_request;
+
+static BaseType_t eeprom_complete(dma_request_event_t *request, dma_response_status status);
+
+static inline uint8_t eeprom_device_address(uint16_t address)
+{
+    return EEPROM_I2C_ADDRESS + (uint8_t)(address >> 8);
+}
+
+void eeprom_init()
+{
+    memset(eeprom_mirror, 0xFF, sizeof(eeprom_mirror));
+    eeprom_loaded = 0;
+    eeprom_lock = MEM_MUTEX_CREATE(eeprom_lock);
+}
+
+dma_response_status eeprom_load()
+{
+    uint8_t chunk[EEPROM_LOAD_CHUNK];
+    dma_request_event_t request;
+    dma_response_event_t response;
+
+    for (uint16_t address = 0; address < EEPROM_SIZE; address += EEPROM_LOAD_CHUNK) {
+        const uint8_t word_address = (uint8_t)address;
+
+        /* the lock is not held during the read, the completion of a page write (dma task) needs it */
+        request.priority = dma_priority_bulk;
+        request.deadline_us = 0;
+        request.type = dma_request_type_i2c_write_read;
+        request.address = eeprom_device_address(address);
+        request.tx_buffer = &word_address;
+        request.tx_length = 1;
+        request.rx_buffer = chunk;
+        request.rx_length = EEPROM_LOAD_CHUNK;
+        if (dma_transfer(&request, &response) != dma_request_status_success) {
+            return dma_request_status_error;
+        }
+
+        /* on a reload the pages that are not yet written back keep the newer data of the mirror */
+        xSemaphoreTake(eeprom_lock, portMAX_DELAY);
+        for (uint16_t page = address / EEPROM_PAGE_SIZE; page < (address + EEPROM_LOAD_CHUNK) / EEPROM_PAGE_SIZE; page++) {
+            if (!(eeprom_dirty & (1UL << page)) && !(eeprom_busy && eeprom_writing == page)) {
+                memcpy(&eeprom_mirror[page * EEPROM_PAGE_SIZE], &chunk[page * EEPROM_PAGE_SIZE - address], EEPROM_PAGE_SIZE);
+            }
+        }
+        if (eeprom_loaded < address + EEPROM_LOAD_CHUNK) {
+            eeprom_loaded = address + EEPROM_LOAD_CHUNK;
+        }
+        xSemaphoreGive(eeprom_lock);
+    }
+
+    return dma_request_status_success;
+}
+
+void eeprom_read(uint16_t address, uint8_t *buffer, uint16_t length)
+{
+    if (address >= EEPROM_SIZE) {
+        memset(buffer, 0xFF, length);
+        return;
+    }
+    if (length > EEPROM_SIZE - address) {
+        memset(&buffer[EEPROM_SIZE - address], 0xFF, length - (EEPROM_SIZE - address));
+        length = EEPROM_SIZE - address;
+    }
+
+    xSemaphoreTake(eeprom_lock, portMAX_DELAY);
+    memcpy(buffer, &eeprom_mirror[address], length);
+    xSemaphoreGive(eeprom_lock);
+}
+
+/* called with the lock held, snapshots the next dirty page into the request */
+static BaseType_t eeprom_next_page(dma_request_event_t *request)
+{
+    if (eeprom_dirty == 0) {
+        eeprom_busy = 0;
+        return pdFALSE;
+    }
+
+    /* a failed page is retried before the other ones */
+    uint16_t page = (eeprom_retries && (eeprom_dirty & (1UL << eeprom_writing))) ? eeprom_writing : __builtin_ctz(eeprom_dirty);
+    uint16_t address = page * EEPROM_PAGE_SIZE;
+    eeprom_dirty &= ~(1UL << page);
+    eeprom_writing = page;
+
+    eeprom_page[0] = (uint8_t)address;
+    memcpy(&eeprom_page[1], &eeprom_mirror[address], EEPROM_PAGE_SIZE);
+
+    /* the request is complete only after the device acknowledges again (end of the write cycle) */
+    request->priority = dma_priority_bulk;
+    request->deadline_us = 0;
+    request->type = dma_request_type_i2c_write_poll;
+    request->address = eeprom_device_address(address);
+    request->tx_buffer = eeprom_page;
+    request->tx_length = sizeof(eeprom_page);
+    request->complete = eeprom_complete;
+
+    eeprom_busy = 1;
+    return pdTRUE;
+}
+
+/* runs in the dma task, chains the next page write without going through the queue */
+static BaseType_t eeprom_complete(dma_request_event_t *request, dma_response_status status)
+{
+    BaseType_t next;
+
+    xSemaphoreTake(eeprom_lock, portMAX_DELAY);
+    if (status != dma_request_status_success && eeprom_retries < EEPROM_WRITE_RETRIES) {
+        /* the page goes back to the dirty ones, a newer write to it is combined into the retry */
+        eeprom_dirty |= (1UL << eeprom_writing);
+        eeprom_retries++;
+    }
+    else {
+        /* written, or given up: the mirror keeps the data until the next write to the page */
+        eeprom_errors += (status != dma_request_status_success);
+        eeprom_retries = 0;
+    }
+    next = eeprom_next_page(request);
+    xSemaphoreGive(eeprom_lock);
+
+    return next;
+}
+
+dma_response_status eeprom_write(uint16_t address, const uint8_t *buffer, uint16_t length)
+{
+    BaseType_t start = pdFALSE;
+
+    if (address >= EEPROM_SIZE || length > EEPROM_SIZE - address) {
+        return dma_request_status_error;
+    }
+    if (length == 0) {
+        return dma_request_status_success;
+    }
+
+    /* the pages are written whole, the rest of a page has to be known first */
+    xSemaphoreTake(eeprom_lock, portMAX_DELAY);
+    if (address + length > eeprom_loaded) {
+        xSemaphoreGive(eeprom_lock);
+        return dma_request_status_error;
+    }
+    memcpy(&eeprom_mirror[address], buffer, length);
+    for (uint16_t page = address / EEPROM_PAGE_SIZE; page <= (address + length - 1) / EEPROM_PAGE_SIZE; page++) {
+        eeprom_dirty |= (1UL << page);
+    }
+
+    /* while a page write is in flight the dirty pages are picked up by its completion */
+    if (!eeprom_busy) {
+        start = eeprom_next_page(&eeprom_request);
+    }
+    xSemaphoreGive(eeprom_lock);
+
+    if (start) {
+        dma_post(&eeprom_request);
+    }
+
+    return dma_request_status_success;
+}
+
+uint8_t eeprom_pending()
+{
+    return eeprom_busy;
+}
+
+uint32_t eeprom_write_errors()
+{
+    return eeprom_errors;
+}
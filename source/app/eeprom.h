@@ -0,0 +1,54 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* AT24C04: 512 bytes in two blocks of 256, the block is selected by the device address */
+#define EEPROM_SIZE         512
+#define EEPROM_PAGE_SIZE    16
+#define EEPROM_BLOCK_SIZE   256
+#define EEPROM_I2C_ADDRESS  0b01010000
+
+/* bytes read per transfer by eeprom_load (divides the block size) */
+#define EEPROM_LOAD_CHUNK   64
+
+/* retries of a failed page write before it is given up */
+#define EEPROM_WRITE_RETRIES    3
+
+void eeprom_init();
+
+/* load the complete device in the ram mirror, the pages written meanwhile are kept */
+dma_response_status eeprom_load();
+
+/* reads are served from ram, writes update ram and are written back to the device in the background,
+   a write is refused until its range is loaded */
+void eeprom_read(uint16_t address, uint8_t *buffer, uint16_t length);
+dma_response_status eeprom_write(uint16_t address, const uint8_t *buffer, uint16_t length);
+
+/* write back state: 1 while pages are still being written, page writes given up since boot */
+uint8_t eeprom_pending();
+uint32_t eeprom_write_errors();
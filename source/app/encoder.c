@@ -0,0 +1,238 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2022 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "task.h"
+#include "semphr.h"
+#include "system.h"
+#include "mem.h"
+#include "gpio.h"
+#include "ring.h"
+#include "encoder.h"
+
+/* events from the interrupts to the consumer task */
+static encoder_event_t encoder_events[ENCODER_EVENTS];
+static ring_t encoder_ring;
+
+/* quarter step for each transition (previous state << 2 | new state), 0 for no move or a skipped state */
+static const int8_t encoder_transition[16] = {
+     0, -1,  1,  0,
+     1,  0,  0, -1,
+    -1,  0,  0,  1,
+     0,  1, -1,  0
+};
+
+static uint8_t encoder_state = ENCODER_REST_STATE;
+static int8_t encoder_quarters = 0;
+
+/* detents not yet taken by the consumer */
+static volatile int32_t encoder_detents = 0;
+static volatile uint32_t encoder_timestamp = 0;
+static volatile uint8_t encoder_pending = 0;
+static volatile uint32_t encoder_edge = 0;
+
+/* stamp of the edge that left the rest state, the start of the detent in progress */
+static uint32_t encoder_motion = 0;
+
+/* the key task samples the pin again once the debounce window of a dropped change is over */
+static uint8_t encoder_key_level = 1;
+static uint32_t encoder_key_timestamp = 0;
+static volatile uint8_t encoder_key_dropped = 0;
+static SemaphoreHandle_t encoder_key_check;
+MEM_SEMAPHORE(encoder_key_check)
+
+void encoder_init()
+{
+    ring_init(&encoder_ring, encoder_events, sizeof(encoder_event_t), ENCODER_EVENTS);
+    encoder_key_check = MEM_SEMAPHORE_CREATE(encoder_key_check);
+
+#if ENCODER_TIMER
+    SET_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM3EN);
+
+    /* both inputs on their own channel with the debounce filter */
+    MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_CC1S_Msk, TIM_CCMR1_CC1S_0);                          /* IC1 mapped on TI1 */
+    MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_CC2S_Msk, TIM_CCMR1_CC2S_0);                          /* IC2 mapped on TI2 */
+    MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_IC1F_Msk, ENCODER_TIMER_FILTER << TIM_CCMR1_IC1F_Pos);
+    MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_IC2F_Msk, ENCODER_TIMER_FILTER << TIM_CCMR1_IC2F_Pos);
+    MODIFY_REG(TIM3->CR1,   TIM_CR1_CKD_Msk,    TIM_CR1_CKD_1);                             /* fDTS = fCK_INT / 4 */
+    MODIFY_REG(TIM3->CCER,  TIM_CCER_CC1P_Msk | TIM_CCER_CC2P_Msk, 0);                      /* not inverted */
+
+    /* encoder mode 3: count on the edges of both inputs */
+    MODIFY_REG(TIM3->SMCR, TIM_SMCR_SMS_Msk, TIM_SMCR_SMS_0 | TIM_SMCR_SMS_1);
+    TIM3->ARR = 0xFFFF;
+    TIM3->CNT = 0;
+    MODIFY_REG(TIM3->CR1, TIM_CR1_CEN_Msk, TIM_CR1_CEN);
+
+    /* stop timer when debuggng */
+    SET_BIT(DBGMCU->APB1FZ, DBGMCU_APB1_FZ_DBG_TIM3_STOP);
+#endif
+}
+
+BaseType_t encoder_receive(encoder_event_t *event, TickType_t timeout)
+{
+    return ring_receive(&encoder_ring, event, timeout);
+}
+
+int32_t encoder_take(uint32_t *timestamp_ms, uint32_t *edge_cycles)
+{
+    int32_t detents;
+
+    taskENTER_CRITICAL();
+    detents = encoder_detents;
+    encoder_detents = 0;
+    *timestamp_ms = encoder_timestamp;
+    *edge_cycles = encoder_edge;
+    encoder_pending = 0;
+    taskEXIT_CRITICAL();
+
+    return detents;
+}
+
+void encoder_isr_rotation_handler(uint8_t ab)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (encoder_state == ENCODER_REST_STATE && ab != ENCODER_REST_STATE) {
+        encoder_motion = system_cycles();
+    }
+    encoder_quarters += encoder_transition[(encoder_state << 2) | ab];
+    encoder_state = ab;
+
+    /* a detent is complete once the rest state is reached again */
+    if (ab != ENCODER_REST_STATE) {
+        return;
+    }
+    if (encoder_quarters >= ENCODER_DETENT_STEPS || encoder_quarters <= -ENCODER_DETENT_STEPS) {
+        encoder_detents += (encoder_quarters > 0) ? 1 : -1;
+        encoder_timestamp = xTaskGetTickCountFromISR() * portTICK_PERIOD_MS;
+
+        /* the consumer is only woken once until it takes the detents, the rest is accumulated */
+        if (!encoder_pending) {
+            encoder_event_t event = { .type = encoder_event_rotation };
+            encoder_edge = encoder_motion;
+            encoder_pending = (ring_put_from_isr(&encoder_ring, &event, &woken) == pdTRUE);
+        }
+    }
+    encoder_quarters = 0;
+
+    portYIELD_FROM_ISR(woken);
+}
+
+void encoder_isr_key_handler(uint8_t level)
+{
+    BaseType_t woken = pdFALSE;
+    uint32_t now = xTaskGetTickCountFromISR() * portTICK_PERIOD_MS;
+
+    if (level == encoder_key_level) {
+        return;
+    }
+
+    /* a change inside the window may be a release that is not bounce, it is not lost but checked later */
+    if ((now - encoder_key_timestamp) < ENCODER_KEY_DEBOUNCE_MS) {
+        if (!encoder_key_dropped) {
+            encoder_key_dropped = 1;
+            xSemaphoreGiveFromISR(encoder_key_check, &woken);
+        }
+        portYIELD_FROM_ISR(woken);
+        return;
+    }
+    encoder_key_level = level;
+    encoder_key_timestamp = now;
+
+    /* the key pulls the line low */
+    encoder_event_t event = { .type = encoder_event_key, .key = level ? encoder_key_released : encoder_key_pressed };
+    ring_put_from_isr(&encoder_ring, &event, &woken);
+
+    portYIELD_FROM_ISR(woken);
+}
+
+/* task side of the debounce, the level of the pin at the end of the window is the one that counts */
+static void encoder_key_resample()
+{
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+
+    /* the key interrupt produces into the same ring, it is masked while this task produces */
+    taskENTER_CRITICAL();
+    if (encoder_key_dropped && (now - encoder_key_timestamp) >= ENCODER_KEY_DEBOUNCE_MS) {
+        uint8_t level = gpio_key_level();
+
+        encoder_key_dropped = 0;
+        if (level != encoder_key_level) {
+            encoder_event_t event = { .type = encoder_event_key, .key = level ? encoder_key_released : encoder_key_pressed };
+            encoder_key_level = level;
+            encoder_key_timestamp = now;
+            ring_put(&encoder_ring, &event);
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+void encoder_run(void *pvParameters)
+{
+    (void)pvParameters;
+
+#if ENCODER_TIMER
+    uint16_t count = TIM3->CNT;
+    int32_t quarters = 0;
+
+    for (;;) {
+        vTaskDelay(ENCODER_POLL_MS / portTICK_PERIOD_MS);
+        encoder_key_resample();
+
+        /* the 16 bit difference is valid as long as less than 32768 edges happen in one period */
+        uint16_t now = TIM3->CNT;
+        quarters += (int16_t)(now - count);
+        count = now;
+
+        int32_t detents = quarters / ENCODER_DETENT_COUNTS;
+        if (detents == 0) {
+            continue;
+        }
+        quarters -= detents * ENCODER_DETENT_COUNTS;
+
+        /* the key interrupt produces into the same ring, it is masked while this task produces */
+        taskENTER_CRITICAL();
+        encoder_detents += detents;
+        encoder_timestamp = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        if (!encoder_pending) {
+            /* the timer does not report its edges, the poll that found them is the stamp */
+            encoder_event_t event = { .type = encoder_event_rotation };
+            encoder_edge = system_cycles();
+            encoder_pending = (ring_put(&encoder_ring, &event) == pdTRUE);
+        }
+        taskEXIT_CRITICAL();
+    }
+#else
+    /* the rotation is decoded in the interrupts, the task only ends the dropped key windows */
+    for (;;) {
+        xSemaphoreTake(encoder_key_check, portMAX_DELAY);
+        vTaskDelay(ENCODER_KEY_DEBOUNCE_MS / portTICK_PERIOD_MS);
+        encoder_key_resample();
+    }
+#endif
+}
@@ -0,0 +1,86 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2022 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* rotation input: 0 decodes the edges of PB0/PB1 in the EXTI interrupts, 1 uses TIM3 in encoder
+   interface mode on PB4 (TIM3_CH1) / PB5 (TIM3_CH2) polled by the encoder task */
+#ifndef ENCODER_TIMER
+#define ENCODER_TIMER           0
+#endif
+
+/* timer mode: polling period and input filter (fDTS/32, 8 samples) */
+#define ENCODER_POLL_MS         10
+#define ENCODER_TIMER_FILTER    0x0F
+
+/* quadrature state of the detent position (A and B high) */
+#define ENCODER_REST_STATE      0x03
+
+/* quarter steps per detent (the timer counts every edge of both inputs) */
+#define ENCODER_DETENT_COUNTS   4
+
+/* quarter steps needed on the way back to the rest state to count a detent */
+#define ENCODER_DETENT_STEPS    3
+
+/* key changes closer than this are contact bounce, the pin is sampled again when the window ends */
+#define ENCODER_KEY_DEBOUNCE_MS 20
+
+/* events buffered between the interrupts and the consumer (power of two) */
+#define ENCODER_EVENTS          8
+
+typedef enum {
+    encoder_event_rotation,
+    encoder_event_key
+} encoder_event_type_t;
+
+typedef enum {
+    encoder_key_pressed,
+    encoder_key_released
+} encoder_key_t;
+
+/* rotation events only signal that detents are pending, they are collected with encoder_take */
+typedef struct encoder_event_t {
+    encoder_event_type_t type;
+    encoder_key_t key;
+} encoder_event_t;
+
+void encoder_init();
+
+/* next event for the single consumer task, returns pdFALSE if none came before the timeout */
+BaseType_t encoder_receive(encoder_event_t *event, TickType_t timeout);
+
+/* signed detents since the last call (positive is clockwise), the time of the last one and the
+   cycle counter stamp of the first edge of the oldest detent not yet taken (timer mode: of the
+   poll that found it) */
+int32_t encoder_take(uint32_t *timestamp_ms, uint32_t *edge_cycles);
+
+/* encoder task: polls the counter in timer mode and samples the key again after a dropped change */
+void encoder_run(void *pvParameters);
+
+/* interrupt handling, called with the pin levels */
+void encoder_isr_rotation_handler(uint8_t ab);
+void encoder_isr_key_handler(uint8_t level);
@@ -0,0 +1,465 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "string.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "mem.h"
+#include "gpio.h"
+#include "system.h"
+#include "st7735.h"
+#include "panel.h"
+#include "rgb444.h"
+#include "trace.h"
+#include "latency.h"
+#include "printf.h"
+#include "fb.h"
+
+/* indexed pixels, row by row, lower nibble is the left pixel in 4 bit mode */
+static uint8_t fb_buffer[FB_HEIGHT * FB_STRIDE];
+
+/* palette used to expand the indexes during the flush */
+static st7735_color_16_bit_t fb_palette[FB_PALETTE_SIZE];
+#if FB_RGB444
+static rgb444_t fb_palette_rgb444[FB_PALETTE_SIZE];
+#endif
+
+/* one packed band of a frame, the frame data travels with its last band. a fill band carries
+   no pixels, its window is filled with the color in data[0] */
+typedef struct fb_band_t {
+    uint8_t x1, y1, x2, y2;
+    uint16_t length;
+    uint8_t fill;
+    uint8_t first;
+    uint8_t last;
+    uint32_t frame_start;
+    uint32_t render;
+    latency_trace_t trace;
+    st7735_color_16_bit_t data[FB_FLUSH_PIXELS];
+} fb_band_t;
+
+/* the bands circulate between the two queues, render takes from free and the flush task from ready */
+static fb_band_t fb_band[FB_BANDS];
+static QueueHandle_t fb_band_free = NULL;
+static QueueHandle_t fb_band_ready = NULL;
+MEM_QUEUE(fb_band_free, FB_BANDS, sizeof(fb_band_t *))
+MEM_QUEUE(fb_band_ready, FB_BANDS, sizeof(fb_band_t *))
+static panel_t *fb_panel = NULL;
+static SemaphoreHandle_t fb_draw_lock = NULL;
+MEM_MUTEX(fb_draw_lock)
+
+/* frame time breakdown, written by the flush task */
+static struct {
+    uint32_t frames;
+    uint64_t total;
+    uint64_t render;
+    uint64_t transfer;
+    uint32_t max;
+} fb_frame_stats;
+
+/* region modified since the last flush (empty if x1 > x2) */
+static struct {
+    uint8_t x1, y1, x2, y2;
+} fb_dirty;
+
+static inline void fb_set(uint16_t x, uint16_t y, fb_color_t color)
+{
+#if FB_BPP == 8
+    fb_buffer[y * FB_STRIDE + x] = color;
+#else
+    uint8_t *p = &fb_buffer[y * FB_STRIDE + (x >> 1)];
+    *p = (x & 1) ? ((*p & 0x0F) | (uint8_t)(color << 4)) : ((*p & 0xF0) | (color & 0x0F));
+#endif
+}
+
+static void fb_fill_row(uint16_t y, int16_t x1, int16_t x2, fb_color_t color)
+{
+#if FB_BPP == 8
+    memset(&fb_buffer[y * FB_STRIDE + x1], color, x2 - x1 + 1);
+#else
+    /* odd start and even end pixels share a byte with their neighbours */
+    if (x1 & 1) {
+        fb_set(x1++, y, color);
+    }
+    if (x1 <= x2 && !(x2 & 1)) {
+        fb_set(x2--, y, color);
+    }
+    if (x1 < x2) {
+        memset(&fb_buffer[y * FB_STRIDE + (x1 >> 1)], (color & 0x0F) | (color << 4), (x2 - x1 + 1) >> 1);
+    }
+#endif
+}
+
+static inline fb_color_t fb_get(uint16_t x, uint16_t y)
+{
+#if FB_BPP == 8
+    return fb_buffer[y * FB_STRIDE + x];
+#else
+    uint8_t pair = fb_buffer[y * FB_STRIDE + (x >> 1)];
+    return (x & 1) ? (pair >> 4) : (pair & 0x0F);
+#endif
+}
+
+void fb_init(panel_t *panel)
+{
+    fb_panel = panel;
+    fb_draw_lock = MEM_MUTEX_CREATE(fb_draw_lock);
+    fb_band_free = MEM_QUEUE_CREATE(fb_band_free, FB_BANDS, sizeof(fb_band_t *));
+    fb_band_ready = MEM_QUEUE_CREATE(fb_band_ready, FB_BANDS, sizeof(fb_band_t *));
+    for (uint8_t i = 0; i < FB_BANDS; i++) {
+        fb_band_t *band = &fb_band[i];
+        xQueueSendToBack(fb_band_free, &band, 0);
+    }
+
+    memset(fb_buffer, 0, sizeof(fb_buffer));
+    memset(fb_palette, 0, sizeof(fb_palette));
+#if FB_RGB444
+    memset(fb_palette_rgb444, 0, sizeof(fb_palette_rgb444));
+#endif
+
+    fb_dirty.x1 = FB_WIDTH - 1;
+    fb_dirty.y1 = FB_HEIGHT - 1;
+    fb_dirty.x2 = 0;
+    fb_dirty.y2 = 0;
+}
+
+void fb_lock()
+{
+    xSemaphoreTake(fb_draw_lock, portMAX_DELAY);
+}
+
+void fb_unlock()
+{
+    xSemaphoreGive(fb_draw_lock);
+}
+
+void fb_set_palette(fb_color_t index, st7735_color_16_bit_t color)
+{
+    fb_palette[index & (FB_PALETTE_SIZE - 1)] = color;
+#if FB_RGB444
+    fb_palette_rgb444[index & (FB_PALETTE_SIZE - 1)] = rgb444_from_rgb565(color);
+#endif
+}
+
+st7735_color_16_bit_t fb_get_palette(fb_color_t index)
+{
+    return fb_palette[index & (FB_PALETTE_SIZE - 1)];
+}
+
+void fb_invalidate(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+    if (x2 >= FB_WIDTH)  x2 = FB_WIDTH - 1;
+    if (y2 >= FB_HEIGHT) y2 = FB_HEIGHT - 1;
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+
+    if (fb_dirty.x1 > fb_dirty.x2) {
+        fb_dirty.x1 = x1; fb_dirty.y1 = y1;
+        fb_dirty.x2 = x2; fb_dirty.y2 = y2;
+    }
+    else {
+        if (x1 < fb_dirty.x1) fb_dirty.x1 = x1;
+        if (y1 < fb_dirty.y1) fb_dirty.y1 = y1;
+        if (x2 > fb_dirty.x2) fb_dirty.x2 = x2;
+        if (y2 > fb_dirty.y2) fb_dirty.y2 = y2;
+    }
+}
+
+void fb_draw_pixel(uint8_t x, uint8_t y, fb_color_t color)
+{
+    if (x >= FB_WIDTH || y >= FB_HEIGHT) {
+        return;
+    }
+
+    fb_set(x, y, color);
+    fb_invalidate(x, y, x, y);
+}
+
+void fb_draw_fill(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, fb_color_t color)
+{
+    if (x2 >= FB_WIDTH)  x2 = FB_WIDTH - 1;
+    if (y2 >= FB_HEIGHT) y2 = FB_HEIGHT - 1;
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+
+    for (uint16_t y = y1; y <= y2; y++) {
+        fb_fill_row(y, x1, x2, color);
+    }
+    fb_invalidate(x1, y1, x2, y2);
+}
+
+void fb_draw_rectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, fb_color_t border, fb_color_t fill)
+{
+    fb_draw_fill(x1, y1, x2, y2, border);
+    if ((x2 - x1) > 1 && (y2 - y1) > 1) {
+        fb_draw_fill(x1 + 1, y1 + 1, x2 - 1, y2 - 1, fill);
+    }
+}
+
+void fb_draw_string(const uint8_t *font, uint8_t x, uint8_t y, fb_color_t fg, fb_color_t bg, const char *txt)
+{
+    /* u8x8 font header: first/last encoding, width/height in 8x8 tiles */
+    const uint8_t first = font[0], last = font[1];
+    const uint8_t tiles_w = font[2], tiles_h = font[3];
+    const uint8_t *glyphs = font + 4;
+    const uint16_t glyph_size = tiles_w * tiles_h * 8;
+    uint16_t x0 = x;
+
+    for (; *txt && (x0 + tiles_w * 8) <= FB_WIDTH; txt++, x0 += tiles_w * 8) {
+        uint8_t c = (uint8_t)*txt;
+        const uint8_t *glyph = (c >= first && c <= last) ? &glyphs[(c - first) * glyph_size] : NULL;
+
+        /* every glyph byte is a column of 8 pixels, lsb on top */
+        for (uint8_t ty = 0; ty < tiles_h; ty++) {
+            for (uint8_t tx = 0; tx < tiles_w; tx++) {
+                for (uint8_t col = 0; col < 8; col++) {
+                    uint8_t bits = glyph ? glyph[(ty * tiles_w + tx) * 8 + col] : 0;
+                    for (uint8_t row = 0; row < 8; row++) {
+                        uint16_t py = y + ty * 8 + row;
+                        if (py < FB_HEIGHT) {
+                            fb_set(x0 + tx * 8 + col, py, (bits & (1 << row)) ? fg : bg);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (x0 > x) {
+        fb_invalidate(x, y, x0 - 1, y + tiles_h * 8 - 1);
+    }
+}
+
+/* waits for a free band, the wait is not part of the render time */
+static fb_band_t *fb_band_take(uint32_t *render, uint32_t *start)
+{
+    fb_band_t *band;
+
+    *render += system_cycles() - *start;
+    xQueueReceive(fb_band_free, &band, portMAX_DELAY);
+    *start = system_cycles();
+
+    return band;
+}
+
+static void fb_band_give(fb_band_t *band, uint8_t first, uint8_t last, uint32_t frame_start, uint32_t *render, uint32_t *start, const latency_trace_t *trace)
+{
+    band->first = first;
+    band->last = last;
+    band->frame_start = frame_start;
+    if (last) {
+        *render += system_cycles() - *start;
+        band->render = *render;
+        band->trace = trace ? *trace : (latency_trace_t){ 0 };
+    }
+    xQueueSendToBack(fb_band_ready, &band, portMAX_DELAY);
+}
+
+void fb_flush_traced(const latency_trace_t *trace)
+{
+    if (fb_dirty.x1 > fb_dirty.x2) {
+        return;
+    }
+    TRACE_DRAW_BEGIN(trace_draw_flush);
+
+    const uint32_t frame_start = system_cycles();
+    uint32_t render = 0, start = frame_start;
+
+    /* pack as many full display columns of the dirty region as fit in a band, the panel memory
+       is written x by x (see panel_set_window) */
+    const uint16_t height = fb_dirty.y2 - fb_dirty.y1 + 1;
+    const uint16_t columns_max = FB_FLUSH_PIXELS / height;
+#if FB_RGB444
+    rgb444_stream_t stream;
+#endif
+
+    for (uint16_t x = fb_dirty.x1; x <= fb_dirty.x2; x += columns_max) {
+        fb_band_t *band = fb_band_take(&render, &start);
+        uint16_t columns = fb_dirty.x2 - x + 1;
+        if (columns > columns_max) {
+            columns = columns_max;
+        }
+
+#if FB_RGB444
+        rgb444_stream_init(&stream, (uint8_t *)band->data);
+        for (uint16_t i = x; i < x + columns; i++) {
+            for (uint16_t y = fb_dirty.y1; y <= fb_dirty.y2; y++) {
+                rgb444_stream_put(&stream, fb_palette_rgb444[fb_get(i, y)]);
+            }
+        }
+        band->length = rgb444_stream_end(&stream);
+#else
+        st7735_color_16_bit_t *dst = band->data;
+        for (uint16_t i = x; i < x + columns; i++) {
+            for (uint16_t y = fb_dirty.y1; y <= fb_dirty.y2; y++) {
+                *dst++ = fb_palette[fb_get(i, y)];
+            }
+        }
+        band->length = (dst - band->data) * sizeof(st7735_color_16_bit_t);
+#endif
+        band->x1 = x;
+        band->y1 = fb_dirty.y1;
+        band->x2 = x + columns - 1;
+        band->y2 = fb_dirty.y2;
+        band->fill = 0;
+        fb_band_give(band, x == fb_dirty.x1, x + columns > fb_dirty.x2, frame_start, &render, &start, trace);
+    }
+    TRACE_DRAW_END(trace_draw_flush);
+
+    fb_dirty.x1 = FB_WIDTH - 1;
+    fb_dirty.y1 = FB_HEIGHT - 1;
+    fb_dirty.x2 = 0;
+    fb_dirty.y2 = 0;
+}
+
+void fb_flush()
+{
+    fb_flush_traced(NULL);
+}
+
+void fb_clear(fb_color_t color)
+{
+    const uint32_t frame_start = system_cycles();
+    uint32_t render = 0, start = frame_start;
+
+#if FB_BPP == 8
+    memset(fb_buffer, color, sizeof(fb_buffer));
+#else
+    memset(fb_buffer, (color & 0x0F) | (color << 4), sizeof(fb_buffer));
+#endif
+
+    /* the panel gets one solid fill, it is queued after the frames already packed */
+    fb_band_t *band = fb_band_take(&render, &start);
+    band->x1 = 0;
+    band->y1 = 0;
+    band->x2 = FB_WIDTH - 1;
+    band->y2 = FB_HEIGHT - 1;
+    band->length = 0;
+    band->fill = 1;
+    band->data[0] = fb_palette[color & (FB_PALETTE_SIZE - 1)];
+    fb_band_give(band, 1, 1, frame_start, &render, &start, NULL);
+
+    fb_dirty.x1 = FB_WIDTH - 1;
+    fb_dirty.y1 = FB_HEIGHT - 1;
+    fb_dirty.x2 = 0;
+    fb_dirty.y2 = 0;
+}
+
+void fb_flush_run(void *pvParameters)
+{
+    (void)pvParameters;
+    uint32_t transfer = 0;
+
+    for (;;) {
+        fb_band_t *band;
+        if (xQueueReceive(fb_band_ready, &band, portMAX_DELAY) != pdPASS) {
+            continue;
+        }
+
+        /* the bus of the panel is held for the whole frame, the st7735 driver is not needed:
+           the panels on other buses are sent meanwhile */
+        if (band->first) {
+            panel_begin(fb_panel);
+            transfer = 0;
+        }
+
+        uint32_t start = system_cycles();
+        if (band->fill) {
+#if FB_RGB444
+            rgb444_draw_fill(fb_panel, band->x1, band->y1, band->x2, band->y2, band->data[0]);
+#else
+            const uint16_t pixels = (band->x2 - band->x1 + 1) * (band->y2 - band->y1 + 1);
+            panel_set_window(fb_panel, band->x1, band->y1, band->x2, band->y2);
+            panel_memory_write(fb_panel, (uint8_t *)band->data, sizeof(st7735_color_16_bit_t), pixels);
+#endif
+        }
+        else {
+            panel_set_window(fb_panel, band->x1, band->y1, band->x2, band->y2);
+            panel_memory_write(fb_panel, (uint8_t *)band->data, band->length, 1);
+        }
+        uint32_t done = system_cycles();
+        transfer += done - start;
+
+        /* the band can be packed again, what is still needed of it is copied first */
+        uint8_t last = band->last;
+        uint32_t frame_start = band->frame_start;
+        uint32_t render = band->render;
+        latency_trace_t trace = band->trace;
+        xQueueSendToBack(fb_band_free, &band, portMAX_DELAY);
+
+        if (last) {
+            panel_end(fb_panel);
+
+            uint32_t total = done - frame_start;
+            taskENTER_CRITICAL();
+            fb_frame_stats.frames++;
+            fb_frame_stats.total += total;
+            fb_frame_stats.render += render;
+            fb_frame_stats.transfer += transfer;
+            if (total > fb_frame_stats.max) {
+                fb_frame_stats.max = total;
+            }
+            taskEXIT_CRITICAL();
+
+            if (trace.edge) {
+                latency_record(latency_stage_draw, trace.received, done);
+                latency_record(latency_stage_total, trace.edge, done);
+            }
+        }
+    }
+}
+
+void fb_report()
+{
+    char txt[80];
+    uint32_t frames, max;
+    uint64_t total, render, transfer;
+
+    taskENTER_CRITICAL();
+    frames = fb_frame_stats.frames;
+    total = fb_frame_stats.total;
+    render = fb_frame_stats.render;
+    transfer = fb_frame_stats.transfer;
+    max = fb_frame_stats.max;
+    memset(&fb_frame_stats, 0, sizeof(fb_frame_stats));
+    taskEXIT_CRITICAL();
+
+    if (frames == 0) {
+        return;
+    }
+
+    /* the bus is idle while the next band is packed, render + transfer above the frame time is the overlap */
+    int length = snprintf(txt, sizeof(txt), "F %lu %lu %lu %lu %lu %lu\n", (unsigned long)frames,
+                          (unsigned long)(total / frames), (unsigned long)(render / frames), (unsigned long)(transfer / frames),
+                          (unsigned long)((total - transfer) / frames), (unsigned long)max);
+    _write(0, txt, length);
+}
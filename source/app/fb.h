@@ -0,0 +1,91 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* framebuffer geometry, same orientation as the st7735 drawing functions */
+#define FB_WIDTH            160
+#define FB_HEIGHT           128
+
+/* bits per pixel of the indexed framebuffer: 4 (16 colors, 10KB) or 8 (256 colors, 20KB) */
+#ifndef FB_BPP
+#define FB_BPP              4
+#endif
+
+/* send the pixels to the display as 12 bit (ST7735_12_PIXEL) instead of 16 bit, off until the
+   frame time is measured on the panel */
+#ifndef FB_RGB444
+#define FB_RGB444           0
+#endif
+
+#define FB_STRIDE           ((FB_WIDTH * FB_BPP) / 8)
+#define FB_PALETTE_SIZE     (1 << FB_BPP)
+
+/* size of a band buffer used while flushing (in pixels) */
+#define FB_FLUSH_PIXELS     (FB_WIDTH * 8)
+
+/* band buffers between the render (fb_flush) and the transfer (fb_flush_run): one is packed
+   while the other one is on the wire */
+#define FB_BANDS            2
+
+/* a framebuffer pixel is an index in the palette */
+typedef uint8_t fb_color_t;
+
+/* initialization, the framebuffer is flushed to the panel */
+void fb_init(panel_t *panel);
+
+/* the framebuffer is shared by the tft and the console tasks, each one takes it for a
+   complete update (drawing and flush) */
+void fb_lock();
+void fb_unlock();
+
+/* palette handling */
+void fb_set_palette(fb_color_t index, st7735_color_16_bit_t color);
+st7735_color_16_bit_t fb_get_palette(fb_color_t index);
+
+/* drawing (in ram only) */
+void fb_draw_pixel(uint8_t x, uint8_t y, fb_color_t color);
+void fb_draw_fill(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, fb_color_t color);
+void fb_draw_rectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, fb_color_t border, fb_color_t fill);
+void fb_draw_string(const uint8_t *font, uint8_t x, uint8_t y, fb_color_t fg, fb_color_t bg, const char *txt);
+
+/* transfer of the modified region to the display: the region is packed into bands that are
+   handed to the flush task, fb_flush returns once the last band is queued. the latency of the
+   trace (draw and total) is recorded when the frame is completely sent */
+void fb_invalidate(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+void fb_flush();
+void fb_flush_traced(const latency_trace_t *trace);
+
+/* fills the framebuffer with one color, the panel gets a solid fill instead of packed pixels */
+void fb_clear(fb_color_t color);
+
+/* transfer stage, holds the bus of the panel while a frame is sent */
+void fb_flush_run(void *pvParameters);
+
+/* print the frame time breakdown since the last report over ITM (cycles):
+       F <frames> <avg frame> <avg render> <avg transfer> <avg bus idle> <max frame> */
+void fb_report();
@@ -0,0 +1,126 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stdint.h"
+#include "string.h"
+#include "frame.h"
+
+/* wrap around safe time comparison */
+static inline int32_t frame_diff(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b);
+}
+
+void frame_init(frame_t *frame, uint32_t period, uint32_t budget)
+{
+    memset(frame, 0, sizeof(frame_t));
+    frame->period = period;
+    frame->budget = budget;
+    frame->quality = frame_quality_full;
+}
+
+uint8_t frame_stride(const frame_t *frame)
+{
+    switch (frame->quality) {
+        case frame_quality_reduced:
+            return 2;
+        case frame_quality_minimal:
+            return 4;
+        default:
+            return 1;
+    }
+}
+
+frame_quality_t frame_quality(const frame_t *frame)
+{
+    return frame->quality;
+}
+
+uint32_t frame_wait(const frame_t *frame, uint32_t now)
+{
+    if (!frame->started || frame_diff(frame->slot, now) <= 0) {
+        return 0;
+    }
+    return frame->slot - now;
+}
+
+void frame_begin(frame_t *frame, uint32_t now)
+{
+    uint8_t stride = frame_stride(frame);
+    uint32_t slot = frame->slot;
+
+    /* after an idle time, a late frame or an early start the slots start again from now */
+    if (!frame->started || frame_diff(now, slot) < 0 || frame_diff(now, slot) >= (int32_t)frame->period) {
+        slot = now;
+    }
+
+    frame->started = 1;
+    frame->begin = now;
+    frame->deadline = slot + frame->period * stride;
+    frame->slot = frame->deadline;
+    frame->stats.skipped += stride - 1;
+}
+
+void frame_end(frame_t *frame, uint32_t now)
+{
+    uint32_t time = now - frame->begin;
+    uint8_t late = frame_diff(now, frame->deadline) > 0;
+    uint8_t over = time > frame->budget;
+
+    frame->stats.frames++;
+    frame->stats.time += time;
+    if (time > frame->stats.time_max) {
+        frame->stats.time_max = time;
+    }
+    frame->stats.missed += late;
+    frame->stats.over += over;
+
+    /* one level down after a few bad frames, one level up after a run of frames within half the budget */
+    if (late || over) {
+        frame->under = 0;
+        if (++frame->over >= FRAME_OVER_LIMIT) {
+            frame->over = 0;
+            if (frame->quality != frame_quality_minimal) {
+                frame->quality++;
+                frame->stats.degraded++;
+            }
+        }
+    }
+    else if (time <= frame->budget / 2) {
+        frame->over = 0;
+        if (++frame->under >= FRAME_RECOVER_LIMIT) {
+            frame->under = 0;
+            if (frame->quality != frame_quality_full) {
+                frame->quality--;
+            }
+        }
+    }
+    else {
+        frame->over = 0;
+        frame->under = 0;
+    }
+}
@@ -0,0 +1,82 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* display frame pacing, plain C without rtos or hardware dependencies, times in us
+   a frame starts at most once per slot of the target period and should take no more than the
+   budget. frames over the budget or past their deadline lower the quality one level, a run of
+   frames well within the budget raises it again:
+     full     a frame every slot
+     reduced  a frame every second slot, the updates of the skipped slot are merged into the next
+              one so the intermediate frames and scroll steps are never drawn
+     minimal  a frame every fourth slot and the work that does not change the text is deferred */
+#define FRAME_OVER_LIMIT    2
+#define FRAME_RECOVER_LIMIT 8
+
+typedef enum {
+    frame_quality_full,
+    frame_quality_reduced,
+    frame_quality_minimal
+} frame_quality_t;
+
+typedef struct frame_stats_t {
+    uint32_t frames;
+    uint32_t skipped;       /* slots left out by the reduced qualities */
+    uint32_t missed;        /* frames that ended past their deadline */
+    uint32_t over;          /* frames over the budget */
+    uint64_t time;
+    uint32_t time_max;
+    uint32_t degraded;      /* quality changes down */
+} frame_stats_t;
+
+typedef struct frame_t {
+    uint32_t period;
+    uint32_t budget;
+    uint8_t started;
+    uint32_t slot;          /* start of the next slot */
+    uint32_t begin;
+    uint32_t deadline;
+    frame_quality_t quality;
+    uint8_t over;
+    uint8_t under;
+    frame_stats_t stats;
+} frame_t;
+
+void frame_init(frame_t *frame, uint32_t period, uint32_t budget);
+
+/* time left until the next frame may start, 0 if it can start now */
+uint32_t frame_wait(const frame_t *frame, uint32_t now);
+
+/* a frame starts at now and ends at now, the end adapts the quality */
+void frame_begin(frame_t *frame, uint32_t now);
+void frame_end(frame_t *frame, uint32_t now);
+
+frame_quality_t frame_quality(const frame_t *frame);
+
+/* slots per frame at the current quality */
+uint8_t frame_stride(const frame_t *frame);
@@ -21,7 +21,7 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 05.Oct.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
  
@@ -29,7 +29,7 @@
 #include "stm32rtos.h"
 #include "queue.h"
 #include "gpio.h"
-#include "rencoder.h"
+#include "encoder.h"
 
 void gpio_init()
 {
@@ -61,48 +61,52 @@ void gpio_init()
     MODIFY_REG(GPIOB->PUPDR, GPIO_PUPDR_PUPD7_Msk, 0);                                                      /* no pull up, no pull down */
 
     /* configuration of the rotary encoder GPIO pins */
+#if ENCODER_TIMER
+    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER4_Msk,  GPIO_MODER_MODER4_1);            /* set the pin as alternate function */
+    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER5_Msk,  GPIO_MODER_MODER5_1);            /* set the pin as alternate function */
+
+    MODIFY_REG(GPIOB->AFR[0], GPIO_AFRL_AFSEL4_Msk, 2 << GPIO_AFRL_AFSEL4_Pos);       /* AF02 - TIM3_CH1 */
+    MODIFY_REG(GPIOB->AFR[0], GPIO_AFRL_AFSEL5_Msk, 2 << GPIO_AFRL_AFSEL5_Pos);       /* AF02 - TIM3_CH2 */
+
+    MODIFY_REG(GPIOB->PUPDR, GPIO_PUPDR_PUPD4_Msk,  0);                               /* no pull up, no pull down */
+    MODIFY_REG(GPIOB->PUPDR, GPIO_PUPDR_PUPD5_Msk,  0);                               /* no pull up, no pull down */
+#else
     MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER0_Msk,  0);                              /* set the pin as input */
     MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER1_Msk,  0);                              /* set the pin as input */
-    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER10_Msk, 0);                              /* set the pin as input */
 
     MODIFY_REG(GPIOB->PUPDR, GPIO_PUPDR_PUPD0_Msk,  0);                               /* no pull up, no pull down */
     MODIFY_REG(GPIOB->PUPDR, GPIO_PUPDR_PUPD1_Msk,  0);                               /* no pull up, no pull down */
-    MODIFY_REG(GPIOB->PUPDR, GPIO_PUPDR_PUPD10_Msk, 0);                               /* no pull up, no pull down */
 
     MODIFY_REG(SYSCFG->EXTICR[0], SYSCFG_EXTICR1_EXTI0,  SYSCFG_EXTICR1_EXTI0_PB);    /* map gpio to EXTI lines */
     MODIFY_REG(SYSCFG->EXTICR[0], SYSCFG_EXTICR1_EXTI1,  SYSCFG_EXTICR1_EXTI1_PB);    /* map gpio to EXTI lines */
+#endif
+    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER10_Msk, 0);                              /* set the pin as input */
+    MODIFY_REG(GPIOB->PUPDR, GPIO_PUPDR_PUPD10_Msk, 0);                               /* no pull up, no pull down */
     MODIFY_REG(SYSCFG->EXTICR[2], SYSCFG_EXTICR3_EXTI10, SYSCFG_EXTICR3_EXTI10_PB);   /* map gpio to EXTI lines */
 
-    /* configure tft control pins */
-    MODIFY_REG(GPIOA->MODER, GPIO_MODER_MODER6_Msk, GPIO_MODER_MODER6_0);   /* set the pin as output */
-    MODIFY_REG(GPIOA->MODER, GPIO_MODER_MODER3_Msk, GPIO_MODER_MODER3_0);   /* set the pin as output */
-
-    MODIFY_REG(GPIOA->OTYPER, GPIO_OTYPER_OT6_Msk, 0);                      /* push pull */
-    MODIFY_REG(GPIOA->OTYPER, GPIO_OTYPER_OT3_Msk, 0);                      /* push pull */
-
-    MODIFY_REG(GPIOA->OSPEEDR, GPIO_OSPEEDR_OSPEED6_Msk, 0);                /* low speed */
-    MODIFY_REG(GPIOA->OSPEEDR, GPIO_OSPEEDR_OSPEED3_Msk, 0);                /* low speed */
-
-    MODIFY_REG(GPIOA->PUPDR, GPIO_PUPDR_PUPD6_Msk, 0);                      /* no pull up, no pull down */
-    MODIFY_REG(GPIOA->PUPDR, GPIO_PUPDR_PUPD3_Msk, 0);                      /* no pull up, no pull down */
-
-    gpio_tft_res_high();
-    gpio_tft_dc_low();
-
     /* configure the SPI pins */
-    MODIFY_REG(GPIOA->MODER, GPIO_MODER_MODER4_Msk, GPIO_MODER_MODER4_1);                                     /* set the pin as alternate function */
     MODIFY_REG(GPIOA->MODER, GPIO_MODER_MODER5_Msk, GPIO_MODER_MODER5_1);                                     /* set the pin as alternate function */
     MODIFY_REG(GPIOA->MODER, GPIO_MODER_MODER7_Msk, GPIO_MODER_MODER7_1);                                     /* set the pin as alternate function */
 
-    MODIFY_REG(GPIOA->OSPEEDR, GPIO_OSPEEDR_OSPEED4_Msk, GPIO_OSPEEDR_OSPEED4_0 | GPIO_OSPEEDR_OSPEED4_1 );   /* high speed */
     MODIFY_REG(GPIOA->OSPEEDR, GPIO_OSPEEDR_OSPEED5_Msk, GPIO_OSPEEDR_OSPEED5_0 | GPIO_OSPEEDR_OSPEED5_1 );   /* high speed */
     MODIFY_REG(GPIOA->OSPEEDR, GPIO_OSPEEDR_OSPEED7_Msk, GPIO_OSPEEDR_OSPEED7_0 | GPIO_OSPEEDR_OSPEED7_1 );   /* high speed */
 
-    MODIFY_REG(GPIOA->AFR[0], GPIO_AFRL_AFSEL4_Msk, 5 << GPIO_AFRL_AFSEL4_Pos);                               /* AF05 - SPI1_NSS */
     MODIFY_REG(GPIOA->AFR[0], GPIO_AFRL_AFSEL5_Msk, 5 << GPIO_AFRL_AFSEL5_Pos);                               /* AF05 - SPI1_SCK */
     MODIFY_REG(GPIOA->AFR[0], GPIO_AFRL_AFSEL7_Msk, 5 << GPIO_AFRL_AFSEL7_Pos);                               /* AF05 - SPI1_MOSI */
 
-    MODIFY_REG(GPIOA->PUPDR, GPIO_PUPDR_PUPD4_Msk, 1 << GPIO_PUPDR_PUPD4_Pos);                                /* pull up */
+    /* the tft control pins (DC, RES, CS) are configured per panel (see panel_init) */
+}
+
+void gpio_spi2_init()
+{
+    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER13_Msk, GPIO_MODER_MODER13_1);                                   /* set the pin as alternate function */
+    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER15_Msk, GPIO_MODER_MODER15_1);                                   /* set the pin as alternate function */
+
+    MODIFY_REG(GPIOB->OSPEEDR, GPIO_OSPEEDR_OSPEED13_Msk, GPIO_OSPEEDR_OSPEED13_0 | GPIO_OSPEEDR_OSPEED13_1); /* high speed */
+    MODIFY_REG(GPIOB->OSPEEDR, GPIO_OSPEEDR_OSPEED15_Msk, GPIO_OSPEEDR_OSPEED15_0 | GPIO_OSPEEDR_OSPEED15_1); /* high speed */
+
+    MODIFY_REG(GPIOB->AFR[1], GPIO_AFRH_AFSEL13_Msk, 5 << GPIO_AFRH_AFSEL13_Pos);                             /* AF05 - SPI2_SCK */
+    MODIFY_REG(GPIOB->AFR[1], GPIO_AFRH_AFSEL15_Msk, 5 << GPIO_AFRH_AFSEL15_Pos);                             /* AF05 - SPI2_MOSI */
 }
 
 void gpio_set_blue_led()
@@ -122,36 +126,70 @@ void gpio_toggle_blue_led()
 
 void gpio_handle_rotation()
 {
-  rencoder_input_event_t event;
-  event.type = rencoder_input_rotation;
-  event.gpio = GPIOB->IDR & 0x03;
-  xQueueSendToBackFromISR(rencoder_input_queue, &event, (TickType_t) 0);
+  encoder_isr_rotation_handler(GPIOB->IDR & 0x03);
+}
+
+uint8_t gpio_key_level()
+{
+  return (GPIOB->IDR & GPIO_IDR_ID10_Msk) ? 1 : 0;
 }
 
 void gpio_handle_key()
 {
-  rencoder_input_event_t event;
-  event.type = rencoder_input_key;
-  event.gpio = (GPIOB->IDR & GPIO_IDR_ID10_Msk) ? 1 : 0;
-  xQueueSendToBackFromISR(rencoder_input_queue, &event, (TickType_t) 0);
+  encoder_isr_key_handler(gpio_key_level());
+}
+
+static void gpio_i2c_delay()
+{
+    /* a few microseconds, keeps the recovery clock below 100kHz */
+    for (volatile uint32_t i = 0; i < 200; i++) {
+    }
 }
 
-void gpio_tft_dc_high()
+void gpio_i2c_recover()
 {
-  GPIOA->BSRR = GPIO_BSRR_BS6;
+    /* take over the I2C pins as open drain outputs, SDA released */
+    GPIOB->BSRR = GPIO_BSRR_BS6 | GPIO_BSRR_BS7;
+    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER6_Msk, GPIO_MODER_MODER6_0);                                   /* set the pin as output */
+    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER7_Msk, GPIO_MODER_MODER7_0);                                   /* set the pin as output */
+
+    /* clock out a slave that still holds SDA low (up to 9 bits) */
+    for (uint8_t i = 0; i < 9 && (GPIOB->IDR & GPIO_IDR_ID7_Msk) == 0; i++) {
+        GPIOB->BSRR = GPIO_BSRR_BR6;
+        gpio_i2c_delay();
+        GPIOB->BSRR = GPIO_BSRR_BS6;
+        gpio_i2c_delay();
+    }
+
+    /* generate a stop condition: SDA low to high while SCL is high */
+    GPIOB->BSRR = GPIO_BSRR_BR6;
+    gpio_i2c_delay();
+    GPIOB->BSRR = GPIO_BSRR_BR7;
+    gpio_i2c_delay();
+    GPIOB->BSRR = GPIO_BSRR_BS6;
+    gpio_i2c_delay();
+    GPIOB->BSRR = GPIO_BSRR_BS7;
+    gpio_i2c_delay();
+
+    /* give the pins back to the I2C peripheral */
+    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER6_Msk, GPIO_MODER_MODER6_1);                                   /* set the pin as alternate function */
+    MODIFY_REG(GPIOB->MODER, GPIO_MODER_MODER7_Msk, GPIO_MODER_MODER7_1);                                   /* set the pin as alternate function */
 }
 
-void gpio_tft_dc_low()
+void gpio_pin_init_output(const gpio_pin_t *pin)
 {
-  GPIOA->BSRR = GPIO_BSRR_BR6;
+    MODIFY_REG(pin->port->MODER,   0x03 << (pin->pin * 2), 0x01 << (pin->pin * 2));    /* set the pin as output */
+    MODIFY_REG(pin->port->OTYPER,  0x01 << pin->pin,       0);                         /* push pull */
+    MODIFY_REG(pin->port->OSPEEDR, 0x03 << (pin->pin * 2), 0);                         /* low speed */
+    MODIFY_REG(pin->port->PUPDR,   0x03 << (pin->pin * 2), 0);                         /* no pull up, no pull down */
 }
 
-void gpio_tft_res_high()
+void gpio_pin_high(const gpio_pin_t *pin)
 {
-  GPIOA->BSRR = GPIO_BSRR_BS3;
+  pin->port->BSRR = (1 << pin->pin);
 }
 
-void gpio_tft_res_low()
+void gpio_pin_low(const gpio_pin_t *pin)
 {
-  GPIOA->BSRR = GPIO_BSRR_BR3;
+  pin->port->BSRR = (1 << (pin->pin + 16));
 }
@@ -21,15 +21,24 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 14.Nov.2021  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
  
 #pragma once
 
+/* generic pin description */
+typedef struct gpio_pin_t {
+    GPIO_TypeDef *port;
+    uint8_t pin;
+} gpio_pin_t;
+
 /* initialization */
 void gpio_init();
 
+/* SCK on PB13 and MOSI on PB15, set up when a panel bus uses SPI2 */
+void gpio_spi2_init();
+
 /* led control */
 void gpio_set_blue_led();
 void gpio_reset_blue_led();
@@ -38,7 +47,13 @@ void gpio_toggle_blue_led();
 void gpio_handle_rotation();
 void gpio_handle_key();
 
-void gpio_tft_dc_high();
-void gpio_tft_dc_low();
-void gpio_tft_res_high();
-void gpio_tft_res_low();
+/* level of the key pin, 0 while pressed */
+uint8_t gpio_key_level();
+
+/* release a stuck I2C bus by clocking SCL by hand */
+void gpio_i2c_recover();
+
+/* generic output pins */
+void gpio_pin_init_output(const gpio_pin_t *pin);
+void gpio_pin_high(const gpio_pin_t *pin);
+void gpio_pin_low(const gpio_pin_t *pin);
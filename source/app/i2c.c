@@ -21,14 +21,30 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 23.Jul.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
 #include "stm32f4xx.h"
+#include "gpio.h"
 #include "i2c.h"
 
-void i2c_init()
+/* transfer state driven by the event interrupt */
+typedef enum {
+    i2c_state_idle,
+    i2c_state_wait_btf,
+    i2c_state_wait_sb,
+    i2c_state_wait_addr,
+    i2c_state_transfer
+} i2c_state_t;
+
+static volatile i2c_state_t i2c_state = i2c_state_idle;
+static uint8_t i2c_address;
+static uint16_t i2c_size;
+static uint8_t i2c_probe;
+static i2c_handler_t i2c_handler = 0;
+
+static void i2c_configure()
 {
     MODIFY_REG(I2C1->CR2, I2C_CR2_FREQ_Msk, 48 << I2C_CR2_FREQ_Pos);            /* match the APB2 frequency */
 
@@ -44,42 +60,152 @@ void i2c_init()
     MODIFY_REG(I2C1->CR1, I2C_CR1_PE_Msk,    I2C_CR1_PE);                       /* enable i2c */
     MODIFY_REG(I2C1->CR2, I2C_CR2_DMAEN_Msk, I2C_CR2_DMAEN);                    /* enable i2c dma */
     MODIFY_REG(I2C1->CR2, I2C_CR2_LAST_Msk,  I2C_CR2_LAST);                     /* enable i2c dma last NACK */
+    MODIFY_REG(I2C1->CR2, I2C_CR2_ITERREN_Msk, I2C_CR2_ITERREN);                /* NACK and bus errors end the transfer */
 }
 
-void i2c_start_write(uint8_t address)
+void i2c_init()
 {
-    // generate a start condition and wait for it to be sent
+    i2c_configure();
+}
+
+void i2c_set_handler(i2c_handler_t handler)
+{
+    i2c_handler = handler;
+}
+
+static void i2c_start(uint8_t address, uint16_t size, uint8_t probe)
+{
+    i2c_address = address;
+    i2c_size = size;
+    i2c_probe = probe;
+    i2c_state = i2c_state_wait_sb;
+
+    /* generate a start condition, the event interrupt continues once SB is set */
+    MODIFY_REG(I2C1->CR2, I2C_CR2_ITEVTEN_Msk, I2C_CR2_ITEVTEN);
     MODIFY_REG(I2C1->CR1, I2C_CR1_START_Msk, I2C_CR1_START);
-    do {
-    } while ((I2C1->SR1 & I2C_SR1_SB_Msk) != I2C_SR1_SB);
-
-    // send address and wait for ADDR and TRA
-    I2C1->DR = (address << 1);
-    do {
-    } while ((I2C1->SR1 & I2C_SR1_ADDR_Msk) != I2C_SR1_ADDR);
-    do {
-    } while ((I2C1->SR2 & I2C_SR2_MSL_Msk) != I2C_SR2_MSL);
+}
+
+void i2c_start_write(uint8_t address)
+{
+    i2c_start(address << 1, 0, 0);
 }
 
 void i2c_start_read(uint8_t address, uint16_t size)
 {
-    // generate a start condition and wait for it to be sent
-    MODIFY_REG(I2C1->CR1, I2C_CR1_START_Msk, I2C_CR1_START);
-    do {
-    } while ((I2C1->SR1 & I2C_SR1_SB_Msk) != I2C_SR1_SB);
-
-    // send address and wait for ADDR
-    I2C1->DR = (address << 1) | 0x01;
-    do {
-    } while ((I2C1->SR1 & I2C_SR1_ADDR_Msk) != I2C_SR1_ADDR);
-    // clear the ACK if only one byte is to be received
-    MODIFY_REG(I2C1->CR1, I2C_CR1_ACK_Msk, ((size > 1) ? I2C_CR1_ACK : 0));
-    do {
-    } while ((I2C1->SR2 & I2C_SR2_MSL_Msk) != I2C_SR2_MSL);
+    i2c_start((address << 1) | 0x01, size, 0);
+}
 
+void i2c_start_probe(uint8_t address)
+{
+    i2c_start(address << 1, 0, 1);
+}
+
+void i2c_restart_read(uint8_t address, uint16_t size)
+{
+    i2c_address = (address << 1) | 0x01;
+    i2c_size = size;
+    i2c_probe = 0;
+    i2c_state = i2c_state_wait_btf;
+
+    /* the last byte is still shifted out, continue in the event interrupt once BTF is set */
+    MODIFY_REG(I2C1->CR2, I2C_CR2_ITEVTEN_Msk, I2C_CR2_ITEVTEN);
+}
+
+static void i2c_finish(i2c_status_t status)
+{
+    MODIFY_REG(I2C1->CR2, I2C_CR2_ITEVTEN_Msk, 0);
+    i2c_state = i2c_state_idle;
+
+    if (i2c_handler) {
+        i2c_handler(status);
+    }
+}
+
+void i2c_isr_event_handler()
+{
+    uint32_t sr1 = I2C1->SR1;
+
+    switch (i2c_state) {
+        case i2c_state_wait_btf:
+            if (sr1 & I2C_SR1_BTF) {
+                MODIFY_REG(I2C1->CR1, I2C_CR1_START_Msk, I2C_CR1_START);
+                i2c_state = i2c_state_wait_sb;
+            }
+            break;
+
+        case i2c_state_wait_sb:
+            if (sr1 & I2C_SR1_SB) {
+                I2C1->DR = i2c_address;
+                i2c_state = i2c_state_wait_addr;
+            }
+            break;
+
+        case i2c_state_wait_addr:
+            if (sr1 & I2C_SR1_ADDR) {
+                /* clear the ACK if only one byte is to be received, then clear ADDR by reading SR2 */
+                if (i2c_address & 0x01) {
+                    MODIFY_REG(I2C1->CR1, I2C_CR1_ACK_Msk, ((i2c_size > 1) ? I2C_CR1_ACK : 0));
+                }
+                (void)I2C1->SR2;
+
+                if (i2c_probe) {
+                    MODIFY_REG(I2C1->CR1, I2C_CR1_STOP_Msk, I2C_CR1_STOP);
+                    i2c_finish(i2c_status_success);
+                    break;
+                }
+
+                /* the DMA takes over, its interrupt ends the transfer */
+                MODIFY_REG(I2C1->CR2, I2C_CR2_ITEVTEN_Msk, 0);
+                i2c_state = i2c_state_transfer;
+            }
+            break;
+
+        default:
+            MODIFY_REG(I2C1->CR2, I2C_CR2_ITEVTEN_Msk, 0);
+            break;
+    }
+}
+
+void i2c_isr_error_handler()
+{
+    uint32_t sr1 = I2C1->SR1;
+    i2c_status_t status = (sr1 & I2C_SR1_AF) ? i2c_status_nack : i2c_status_error;
+
+    /* clear the error flags */
+    MODIFY_REG(I2C1->SR1, I2C_SR1_AF_Msk | I2C_SR1_BERR_Msk | I2C_SR1_ARLO_Msk | I2C_SR1_OVR_Msk | I2C_SR1_TIMEOUT_Msk | I2C_SR1_PECERR_Msk, 0);
+
+    /* the bus is lost after an arbitration loss, otherwise release it */
+    if ((sr1 & I2C_SR1_ARLO) == 0) {
+        MODIFY_REG(I2C1->CR1, I2C_CR1_STOP_Msk, I2C_CR1_STOP);
+    }
+
+    if (i2c_state != i2c_state_idle) {
+        i2c_finish(status);
+    }
 }
 
 void i2c_stop()
 {
     MODIFY_REG(I2C1->CR1, I2C_CR1_STOP_Msk, I2C_CR1_STOP);
+    i2c_state = i2c_state_idle;
+}
+
+void i2c_abort()
+{
+    MODIFY_REG(I2C1->CR2, I2C_CR2_ITEVTEN_Msk, 0);
+    i2c_state = i2c_state_idle;
+    MODIFY_REG(I2C1->CR1, I2C_CR1_STOP_Msk, I2C_CR1_STOP);
+}
+
+void i2c_recover()
+{
+    /* free the lines from a slave stuck in the middle of a byte */
+    MODIFY_REG(I2C1->CR1, I2C_CR1_PE_Msk, 0);
+    gpio_i2c_recover();
+
+    /* reset the peripheral, BUSY can stay set after a bus error */
+    MODIFY_REG(I2C1->CR1, I2C_CR1_SWRST_Msk, I2C_CR1_SWRST);
+    MODIFY_REG(I2C1->CR1, I2C_CR1_SWRST_Msk, 0);
+
+    i2c_configure();
 }
@@ -21,14 +21,39 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 23.Jul.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
- /* initialization */
+#pragma once
+
+/* outcome of the phases driven by the i2c interrupts */
+typedef enum {
+    i2c_status_success,
+    i2c_status_nack,
+    i2c_status_error
+} i2c_status_t;
+
+/* called from interrupt context when a transfer ends without the DMA (probe, NACK, bus error) */
+typedef void (*i2c_handler_t)(i2c_status_t status);
+
+/* initialization */
 void i2c_init();
+void i2c_set_handler(i2c_handler_t handler);
 
-/* dma based read/write */
+/* start and address phase run in the event interrupt, the data phase is done by the DMA */
 void i2c_start_write(uint8_t address);
 void i2c_start_read(uint8_t address, uint16_t size);
+void i2c_restart_read(uint8_t address, uint16_t size);
 void i2c_stop();
+
+/* address only transfer, the result is reported to the handler */
+void i2c_start_probe(uint8_t address);
+
+/* abort the transfer in progress and recover the bus (task context) */
+void i2c_abort();
+void i2c_recover();
+
+/* interrupt handling */
+void i2c_isr_event_handler();
+void i2c_isr_error_handler();
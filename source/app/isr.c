@@ -21,29 +21,68 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 14.Nov.2021  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
 #include "stm32f4xx.h"
 #include "stm32rtos.h"
 #include "queue.h"
+#include "task.h"
 #include "isr.h"
 #include "gpio.h"
+#include "encoder.h"
+#include "sched.h"
 #include "dma.h"
+#include "i2c.h"
+#include "spi.h"
+#include "printf.h"
+#include "system.h"
+
+#if ISR_PROFILE
+static isr_profile_t isr_profile[isr_count];
+
+static const char *isr_name[isr_count] = {
+    "exti0",
+    "exti1",
+    "exti15_10",
+    "dma1_s0",
+    "dma1_s1",
+    "i2c1_ev",
+    "i2c1_er",
+    "dma2_s3",
+    "dma1_s4"
+};
+
+static const IRQn_Type isr_irq[isr_count] = {
+    EXTI0_IRQn,
+    EXTI1_IRQn,
+    EXTI15_10_IRQn,
+    DMA1_Stream0_IRQn,
+    DMA1_Stream1_IRQn,
+    I2C1_EV_IRQn,
+    I2C1_ER_IRQn,
+    DMA2_Stream3_IRQn,
+    DMA1_Stream4_IRQn
+};
+#endif
 
 void isr_init()
 {
-    /* mask the EXTI lines as interupts */
+    /* mask the EXTI lines as interupts, the timer counts the rotation in encoder timer mode */
+#if !ENCODER_TIMER
     MODIFY_REG(EXTI->IMR, EXTI_IMR_MR0_Msk,  EXTI_IMR_MR0);
     MODIFY_REG(EXTI->IMR, EXTI_IMR_MR1_Msk,  EXTI_IMR_MR1);
+#endif
     MODIFY_REG(EXTI->IMR, EXTI_IMR_MR10_Msk, EXTI_IMR_MR10);
 
     /* set rising edge as trigger */
+#if !ENCODER_TIMER
     MODIFY_REG(EXTI->RTSR, EXTI_RTSR_TR0_Msk,  EXTI_RTSR_TR0);
     MODIFY_REG(EXTI->FTSR, EXTI_FTSR_TR0_Msk,  EXTI_FTSR_TR0);
     MODIFY_REG(EXTI->RTSR, EXTI_RTSR_TR1_Msk,  EXTI_RTSR_TR1);
     MODIFY_REG(EXTI->FTSR, EXTI_FTSR_TR1_Msk,  EXTI_FTSR_TR1);
+#endif
     MODIFY_REG(EXTI->RTSR, EXTI_RTSR_TR10_Msk, EXTI_RTSR_TR10);
     MODIFY_REG(EXTI->FTSR, EXTI_FTSR_TR10_Msk, EXTI_FTSR_TR10);
 
@@ -53,38 +92,162 @@ void isr_init()
     NVIC_SetPriority(EXTI15_10_IRQn,    NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 11 /* PreemptPriority */, 0 /* SubPriority */));
     NVIC_SetPriority(DMA1_Stream0_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 11 /* PreemptPriority */, 0 /* SubPriority */));
     NVIC_SetPriority(DMA1_Stream1_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 11 /* PreemptPriority */, 0 /* SubPriority */));
+    NVIC_SetPriority(I2C1_EV_IRQn,      NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 11 /* PreemptPriority */, 0 /* SubPriority */));
+    NVIC_SetPriority(I2C1_ER_IRQn,      NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 11 /* PreemptPriority */, 0 /* SubPriority */));
+    NVIC_SetPriority(DMA2_Stream3_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 11 /* PreemptPriority */, 0 /* SubPriority */));
+    NVIC_SetPriority(DMA1_Stream4_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 11 /* PreemptPriority */, 0 /* SubPriority */));
 
+#if !ENCODER_TIMER
     NVIC_EnableIRQ(EXTI0_IRQn);
     NVIC_EnableIRQ(EXTI1_IRQn);
+#endif
     NVIC_EnableIRQ(EXTI15_10_IRQn);
     NVIC_EnableIRQ(DMA1_Stream0_IRQn);
     NVIC_EnableIRQ(DMA1_Stream1_IRQn);
+    NVIC_EnableIRQ(I2C1_EV_IRQn);
+    NVIC_EnableIRQ(I2C1_ER_IRQn);
+    NVIC_EnableIRQ(DMA2_Stream3_IRQn);
+    NVIC_EnableIRQ(DMA1_Stream4_IRQn);
+}
+
+static inline uint32_t isr_enter(isr_id_t id)
+{
+    (void)id;
+#if ISR_PROFILE
+    return system_cycles();
+#else
+    return 0;
+#endif
+}
+
+static inline void isr_exit(isr_id_t id, uint32_t start)
+{
+#if ISR_PROFILE
+    uint32_t duration = system_cycles() - start;
+    isr_profile_t *profile = &isr_profile[id];
+
+    profile->count++;
+    profile->cycles += duration;
+    if (duration > profile->max) {
+        profile->max = duration;
+    }
+
+    /* the interrupts that became pending meanwhile waited for this handler */
+    for (uint8_t i = 0; i < isr_count; i++) {
+        if (i != id && NVIC_GetPendingIRQ(isr_irq[i])) {
+            isr_profile[i].blocked++;
+            if (duration > isr_profile[i].blocked_max) {
+                isr_profile[i].blocked_max = duration;
+                isr_profile[i].blocked_by = id;
+            }
+        }
+    }
+#else
+    (void)id;
+    (void)start;
+#endif
+}
+
+void isr_report()
+{
+#if ISR_PROFILE
+    char txt[96];
+    uint32_t average[isr_count];
+    uint8_t order[isr_count];
+
+    for (uint8_t i = 0; i < isr_count; i++) {
+        const isr_profile_t *profile = &isr_profile[i];
+        average[i] = profile->count ? (uint32_t)(profile->cycles / profile->count) : 0;
+        int length = snprintf(txt, sizeof(txt), "I %s %lu %lu %lu %lu %lu %s\n", isr_name[i],
+                              (unsigned long)profile->count, (unsigned long)average[i], (unsigned long)profile->max,
+                              (unsigned long)profile->blocked, (unsigned long)profile->blocked_max,
+                              profile->blocked ? isr_name[profile->blocked_by] : "-");
+        _write(0, txt, length);
+    }
+
+    /* shortest handlers first: they delay the others the least when they pre-empt them */
+    for (uint8_t i = 0; i < isr_count; i++) {
+        order[i] = i;
+    }
+    for (uint8_t i = 1; i < isr_count; i++) {
+        for (uint8_t j = i; j > 0 && average[order[j]] < average[order[j - 1]]; j--) {
+            uint8_t t = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = t;
+        }
+    }
+
+    int length = snprintf(txt, sizeof(txt), "P");
+    for (uint8_t i = 0; i < isr_count; i++) {
+        length += snprintf(&txt[length], sizeof(txt) - length, " %s", isr_name[order[i]]);
+    }
+    length += snprintf(&txt[length], sizeof(txt) - length, "\n");
+    _write(0, txt, length);
+#endif
 }
 
 void EXTI0_IRQHandler(void)
 {
+  uint32_t start = isr_enter(isr_exti0);
   gpio_handle_rotation();
   SET_BIT(EXTI->PR, EXTI_PR_PR0_Msk);
+  isr_exit(isr_exti0, start);
 }
 
 void EXTI1_IRQHandler(void)
 {
+  uint32_t start = isr_enter(isr_exti1);
   gpio_handle_rotation();
   SET_BIT(EXTI->PR, EXTI_PR_PR1_Msk);
+  isr_exit(isr_exti1, start);
 }
 
 void EXTI15_10_IRQHandler(void)
 {
+  uint32_t start = isr_enter(isr_exti15_10);
   gpio_handle_key();
   SET_BIT(EXTI->PR, EXTI_PR_PR10_Msk);
+  isr_exit(isr_exti15_10, start);
 }
 
 void DMA1_Stream0_IRQHandler(void)
 {
+  uint32_t start = isr_enter(isr_dma1_stream0);
   dma_isr_rx_handler();
+  isr_exit(isr_dma1_stream0, start);
 }
 
 void DMA1_Stream1_IRQHandler(void)
 {
+  uint32_t start = isr_enter(isr_dma1_stream1);
   dma_isr_tx_handler();
+  isr_exit(isr_dma1_stream1, start);
+}
+
+void I2C1_EV_IRQHandler(void)
+{
+  uint32_t start = isr_enter(isr_i2c1_ev);
+  i2c_isr_event_handler();
+  isr_exit(isr_i2c1_ev, start);
+}
+
+void I2C1_ER_IRQHandler(void)
+{
+  uint32_t start = isr_enter(isr_i2c1_er);
+  i2c_isr_error_handler();
+  isr_exit(isr_i2c1_er, start);
+}
+
+void DMA2_Stream3_IRQHandler(void)
+{
+  uint32_t start = isr_enter(isr_dma2_stream3);
+  spi_isr_dma_tx_handler(SPI1);
+  isr_exit(isr_dma2_stream3, start);
+}
+
+void DMA1_Stream4_IRQHandler(void)
+{
+  uint32_t start = isr_enter(isr_dma1_stream4);
+  spi_isr_dma_tx_handler(SPI2);
+  isr_exit(isr_dma1_stream4, start);
 }
@@ -21,10 +21,46 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 12.Oct.2021  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
  
 #pragma once
 
+/* handler duration profiling (DWT cycle counter), off by default: besides the two counter reads
+   and the statistics update, every exit scans the pending bits of all the profiled interrupts,
+   roughly 100 cycles per interrupt (estimated from the code, not measured) */
+#ifndef ISR_PROFILE
+#define ISR_PROFILE     0
+#endif
+
+typedef enum {
+    isr_exti0,
+    isr_exti1,
+    isr_exti15_10,
+    isr_dma1_stream0,
+    isr_dma1_stream1,
+    isr_i2c1_ev,
+    isr_i2c1_er,
+    isr_dma2_stream3,
+    isr_dma1_stream4,
+    isr_count
+} isr_id_t;
+
+/* statistics of one handler, the blocked time is the duration of the handlers that ran while
+   this interrupt was pending: an upper bound of its latency caused by other handlers */
+typedef struct isr_profile_t {
+    uint32_t count;
+    uint64_t cycles;
+    uint32_t max;
+    uint32_t blocked;
+    uint32_t blocked_max;
+    isr_id_t blocked_by;
+} isr_profile_t;
+
 void isr_init();
+
+/* print the profile and the recommended priority ordering over ITM:
+       I <name> <count> <avg cycles> <max cycles> <times blocked> <max blocked cycles> <blocked by>
+       P <name> ... (highest priority first) */
+void isr_report();
@@ -0,0 +1,125 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "string.h"
+#include "task.h"
+#include "system.h"
+#include "printf.h"
+#include "latency.h"
+
+static latency_histogram_t latency_histogram[latency_stages];
+
+static const char *latency_stage_name[latency_stages] = {
+    "input",
+    "handler",
+    "queue",
+    "draw",
+    "total"
+};
+
+static uint8_t latency_bucket(uint32_t us)
+{
+    if (us < 4) {
+        return us;
+    }
+
+    uint8_t octave = 31 - __builtin_clz(us);
+    uint8_t index = 4 + (octave - 2) * 4 + ((us >> (octave - 2)) & 0x03);
+    return (index < LATENCY_BUCKETS) ? index : LATENCY_BUCKETS - 1;
+}
+
+static uint32_t latency_bucket_limit(uint8_t index)
+{
+    if (index < 4) {
+        return index;
+    }
+
+    /* upper limit of the bucket */
+    uint8_t octave = 2 + (index - 4) / 4;
+    return ((4 + ((index - 4) & 0x03) + 1) << (octave - 2)) - 1;
+}
+
+void latency_init()
+{
+    for (uint8_t i = 0; i < latency_stages; i++) {
+        memset(&latency_histogram[i], 0, sizeof(latency_histogram_t));
+        latency_histogram[i].min = UINT32_MAX;
+    }
+}
+
+void latency_record(latency_stage_t stage, uint32_t from, uint32_t to)
+{
+    latency_histogram_t *histogram = &latency_histogram[stage];
+    uint32_t us = (to - from) / (configCPU_CLOCK_HZ / 1000000);
+
+    taskENTER_CRITICAL();
+    histogram->count++;
+    histogram->bucket[latency_bucket(us)]++;
+    if (us < histogram->min) {
+        histogram->min = us;
+    }
+    if (us > histogram->max) {
+        histogram->max = us;
+    }
+    taskEXIT_CRITICAL();
+}
+
+uint32_t latency_percentile(latency_stage_t stage, uint8_t percent)
+{
+    const latency_histogram_t *histogram = &latency_histogram[stage];
+    uint32_t rank = (histogram->count * percent + 99) / 100;
+    uint32_t sum = 0;
+
+    for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+        sum += histogram->bucket[i];
+        if (sum >= rank && sum > 0) {
+            /* the bucket limit can be above the largest sample */
+            uint32_t limit = latency_bucket_limit(i);
+            return (limit < histogram->max) ? limit : histogram->max;
+        }
+    }
+    return 0;
+}
+
+void latency_dump()
+{
+    char txt[80];
+
+    for (uint8_t i = 0; i < latency_stages; i++) {
+        const latency_histogram_t *histogram = &latency_histogram[i];
+        int length = snprintf(txt, sizeof(txt), "lat %-7s n=%lu min=%lu p50=%lu p99=%lu max=%lu us\n",
+                              latency_stage_name[i],
+                              (unsigned long)histogram->count,
+                              (unsigned long)(histogram->count ? histogram->min : 0),
+                              (unsigned long)latency_percentile(i, 50),
+                              (unsigned long)latency_percentile(i, 99),
+                              (unsigned long)histogram->max);
+        _write(0, txt, length);
+    }
+}
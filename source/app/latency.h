@@ -0,0 +1,66 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* end to end latency of an encoder detent up to the last pixel sent to the display */
+typedef enum {
+    latency_stage_input,        /* edge in the EXTI interrupt to the user handler */
+    latency_stage_handler,      /* user handler to the tft queue */
+    latency_stage_queue,        /* tft queue to the tft task */
+    latency_stage_draw,         /* tft task to the end of the flush */
+    latency_stage_total,        /* edge to the end of the flush */
+    latency_stages
+} latency_stage_t;
+
+/* histogram: 4 linear buckets, then 4 buckets per power of two (in us) up to about 2s */
+#define LATENCY_BUCKETS     80
+
+/* cycle counter stamps carried with an update, edge is 0 for updates not caused by the encoder */
+typedef struct latency_trace_t {
+    uint32_t edge;
+    uint32_t received;
+    uint32_t sent;
+} latency_trace_t;
+
+typedef struct latency_histogram_t {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t bucket[LATENCY_BUCKETS];
+} latency_histogram_t;
+
+void latency_init();
+
+/* add the time between two cycle counter stamps to the histogram of a stage */
+void latency_record(latency_stage_t stage, uint32_t from, uint32_t to);
+
+/* value in us below which the given percentage of the samples are */
+uint32_t latency_percentile(latency_stage_t stage, uint8_t percent);
+
+/* print min/p50/p99/max of all stages over ITM */
+void latency_dump();
@@ -21,7 +21,7 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 05.Oct.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
@@ -30,89 +30,184 @@
 #include "string.h"
 #include "task.h"
 #include "queue.h"
+#include "mem.h"
 #include "system.h"
 #include "gpio.h"
 #include "isr.h"
 #include "i2c.h"
 #include "spi.h"
+#include "sched.h"
 #include "dma.h"
 #include "printf.h"
 #include "led.h"
+#include "trace.h"
+#include "latency.h"
+#include "stats.h"
+#include "st7735.h"
+#include "panel.h"
+#include "fb.h"
+#include "update.h"
 #include "tft.h"
-#include "rencoder.h"
+#include "console.h"
+#include "eeprom.h"
+#include "encoder.h"
+#include "accel.h"
 
-#define EEPROM_SIZE         512
-#define EEPROM_PAGE_SIZE    16
-#define EEPROM_I2C_ADDRESS  0b01010000
+/* stack sizes in words, tuned with the free stack reported by the stats task */
+#define LED_STACK_WORDS         configMINIMAL_STACK_SIZE
+#define TFT_STACK_WORDS         (configMINIMAL_STACK_SIZE * 2)
+#define DMA_STACK_WORDS         (configMINIMAL_STACK_SIZE * 2)
+#define USER_STACK_WORDS        (configMINIMAL_STACK_SIZE * 2)
+#define STATS_STACK_WORDS       (configMINIMAL_STACK_SIZE * 2)
+#define ENCODER_STACK_WORDS     configMINIMAL_STACK_SIZE
+#define FLUSH_STACK_WORDS       configMINIMAL_STACK_SIZE
+#define CONSOLE_STACK_WORDS     configMINIMAL_STACK_SIZE
 
-static void query_eeprom(uint16_t counter, tft_event_type_t tft_event_type)
+MEM_TASK(led_run,      LED_STACK_WORDS)
+MEM_TASK(tft_run,      TFT_STACK_WORDS)
+MEM_TASK(fb_flush_run, FLUSH_STACK_WORDS)
+MEM_TASK(dma_run,      DMA_STACK_WORDS)
+MEM_TASK(user_handler, USER_STACK_WORDS)
+MEM_TASK(stats_run,    STATS_STACK_WORDS)
+MEM_TASK(console_run,  CONSOLE_STACK_WORDS)
+#if ENCODER_TIMER
+MEM_TASK(encoder_run,  ENCODER_STACK_WORDS)
+#endif
+
+/* the hand over to the tft task ends the handler stage */
+static void query_stamp(latency_trace_t *trace)
 {
-    dma_request_event_t dma_request_event;
-    dma_response_event_t dma_response_event;
-    tft_event_t tft_event = { 0 };
-
-    // set the location for the read
-    dma_request_event.length = 1;
-    dma_request_event.type = dma_request_type_i2c_write;
-    dma_request_event.address = EEPROM_I2C_ADDRESS + (uint8_t)(counter >> 8); // calculate the read address of the eeprom
-    dma_request_event.buffer[0] = (uint8_t)counter;                           // low part needs to be send as data / high byte needs to be send in address
-    xQueueSendToBack(dma_request_queue, &dma_request_event, (TickType_t) 1);
-    if (xQueueReceive(dma_response_queue, &dma_response_event, portMAX_DELAY) == pdPASS) {
-        if (dma_response_event.status != dma_request_status_success) {
-            sprintf(tft_event.row_txt, "%s [%d]", "Write error", dma_response_event.length);
-        }
-        else {
-            dma_request_event.length = 16;
-            dma_request_event.type = dma_request_type_i2c_read;
-            dma_request_event.address = EEPROM_I2C_ADDRESS;
-            xQueueSendToBack(dma_request_queue, &dma_request_event, (TickType_t) 1);
-            if (xQueueReceive(dma_response_queue, &dma_response_event, portMAX_DELAY) == pdPASS) {
-                if (dma_response_event.status != dma_request_status_success) {
-                    sprintf(tft_event.row_txt, "%s [%d]", "Read error", dma_response_event.length);
-                }
-                else {
-                    memset(tft_event.row_txt, 0, sizeof(tft_event.row_txt));
-                    memcpy(tft_event.row_txt, dma_response_event.buffer, dma_response_event.length);
-                }
-            }
-        }
+    if (trace != NULL) {
+        trace->sent = system_cycles();
+        latency_record(latency_stage_handler, trace->received, trace->sent);
+    }
+}
+
+static void query_eeprom(uint16_t counter, int8_t direction, latency_trace_t *trace)
+{
+    char row_txt[17];
+
+    // the row is read from the ram mirror of the eeprom, the tft merges it into the pending update
+    eeprom_read(counter, (uint8_t *)row_txt, 16);
+    row_txt[16] = 0;
+
+    query_stamp(trace);
+    tft_post_scroll(direction, row_txt, trace);
+}
+
+static void query_eeprom_rows(int32_t position, latency_trace_t *trace)
+{
+    char rows_txt[TFT_ROWS][17];
+
+    // all the rows of the window ending at position, posted as a single jump
+    for (uint8_t i = 0; i < TFT_ROWS; i++) {
+        eeprom_read((position - (TFT_ROWS - 1) + i) * 16, (uint8_t *)rows_txt[i], 16);
+        rows_txt[i][16] = 0;
     }
 
-    tft_event.type = tft_event_type;
-    xQueueSendToBack(tft_queue, &tft_event, (TickType_t) 1);
+    query_stamp(trace);
+    tft_post_rows(rows_txt, trace);
 }
 
+/* encoder acceleration: one row per detent, 4 rows above 10 detents/s, a page above 25 detents/s */
+static const accel_stage_t user_accel_curve[] = {
+    {  0, 1 },
+    { 10, 4 },
+    { 25, TFT_ROWS },
+};
+
+/* diagnostics line below the text rows, redrawn at most 10 times per second */
+static const console_config_t user_console = {
+    .x = 2*8,
+    .y = 112,
+    .rows = 1,
+    .fg = tft_color_black,
+    .bg = tft_color_white,
+    .period_ms = 100
+};
+
+/* the last page of the eeprom keeps the position of the browser, the rows above it are shown.
+   the position is written once the encoder rests for USER_SAVE_MS */
+#define USER_ROWS               (EEPROM_SIZE / 16 - 1)
+#define USER_SETTINGS_ADDRESS   (EEPROM_SIZE - EEPROM_PAGE_SIZE)
+#define USER_SETTINGS_MAGIC     0xA5
+#define USER_SAVE_MS            2000
+
 static void user_handler(void *pvParameters)
 {
     (void)pvParameters;
+    int32_t position = TFT_ROWS - 1;
+    int32_t saved;
+    uint8_t settings[2];
+    accel_t accel;
 
-    query_eeprom(0 * 16, tft_event_text_up);
-    query_eeprom(1 * 16, tft_event_text_up);
-    query_eeprom(2 * 16, tft_event_text_up);
-    query_eeprom(3 * 16, tft_event_text_up);
-    query_eeprom(4 * 16, tft_event_text_up);
-    query_eeprom(5 * 16, tft_event_text_up);
+    accel_init(&accel, user_accel_curve, sizeof(user_accel_curve) / sizeof(accel_stage_t));
+
+    // load the complete eeprom once, the browser works on the ram mirror
+    if (eeprom_load() != dma_request_status_success) {
+        console_printf("eeprom error\n");
+    }
+
+    // start where the last session stopped
+    eeprom_read(USER_SETTINGS_ADDRESS, settings, sizeof(settings));
+    if (settings[0] == USER_SETTINGS_MAGIC && settings[1] >= TFT_ROWS - 1 && settings[1] <= USER_ROWS - 1) {
+        position = settings[1];
+    }
+    saved = position;
+
+    query_eeprom_rows(position, NULL);
 
     for (;;) {
-        rencoder_output_event_t event;
-        if (xQueueReceive(rencoder_output_queue, &event, portMAX_DELAY) == pdPASS) {
-            if (event.type == rencoder_output_rotation && event.direction == RENCODER_DIR_CW) {
-                query_eeprom(event.position * 16, tft_event_text_up);
+        encoder_event_t event;
+        TickType_t timeout = (position != saved) ? USER_SAVE_MS / portTICK_PERIOD_MS : portMAX_DELAY;
+        if (encoder_receive(&event, timeout) == pdPASS) {
+            TRACE_QUEUE_RECEIVE(trace_queue_encoder, event.type);
+            if (event.type == encoder_event_rotation) {
+                // all the detents counted since the last event, the latest position wins
+                latency_trace_t trace = { 0 };
+                uint32_t timestamp;
+                int32_t detents = encoder_take(&timestamp, &trace.edge);
+
+                trace.received = system_cycles();
+                latency_record(latency_stage_input, trace.edge, trace.received);
+
+                // the speed of the rotation scales the move, the window stays inside the eeprom
+                int32_t target = position + accel_update(&accel, detents, timestamp);
+                if (target < TFT_ROWS - 1) {
+                    target = TFT_ROWS - 1;
+                }
+                if (target > USER_ROWS - 1) {
+                    target = USER_ROWS - 1;
+                }
+
+                // a single step scrolls by one row, anything larger jumps to the final window
+                if (target == position + 1) {
+                    query_eeprom(target * 16, 1, &trace);
+                }
+                else if (target == position - 1) {
+                    query_eeprom((target - (TFT_ROWS - 1)) * 16, -1, &trace);
+                }
+                else if (target != position) {
+                    query_eeprom_rows(target, &trace);
+                }
+                if (target != position) {
+                    console_printf("row %ld/%d\n", (long)target, USER_ROWS - 1);
+                }
+                position = target;
+            }
+            else if ((event.type == encoder_event_key) && (event.key == encoder_key_pressed)) {
+                latency_dump();
+            }
+            else if ((event.type == encoder_event_key) && (event.key == encoder_key_released)) {
+                tft_post_background();
             }
-            else if (event.type == rencoder_output_rotation && event.direction == RENCODER_DIR_CCW) {
-                query_eeprom((event.position - 5) * 16, tft_event_text_down);
-            } 
-            else if ((event.type == rencoder_output_key) && (event.key == RENCODER_KEY_RELEASED)) {
-                //rencoder_reset();
-                //query_eeprom(0 * 16, tft_event_text_up);
-                //query_eeprom(1 * 16, tft_event_text_up);
-                //query_eeprom(2 * 16, tft_event_text_up);
-                //query_eeprom(3 * 16, tft_event_text_up);
-                //query_eeprom(4 * 16, tft_event_text_up);
-                //query_eeprom(5 * 16, tft_event_text_up);
-                tft_event_t tft_event = { 0 };
-                tft_event.type = tft_event_background;
-                xQueueSendToBack(tft_queue, &tft_event, (TickType_t) 1);
+        }
+        else {
+            // the encoder rests, one write cycle per stop instead of one per detent
+            settings[0] = USER_SETTINGS_MAGIC;
+            settings[1] = (uint8_t)position;
+            if (eeprom_write(USER_SETTINGS_ADDRESS, settings, sizeof(settings)) == dma_request_status_success) {
+                saved = position;
             }
         }
     }
@@ -126,6 +221,9 @@ int main(void)
     /* initialize the gpio */
     gpio_init();
 
+    /* binary event trace over ITM */
+    trace_init();
+
     /* initialize the interupt service routines */
     isr_init();
 
@@ -138,21 +236,39 @@ int main(void)
     /* initialize the dma controller */
     dma_init();
 
+    /* init the eeprom mirror */
+    eeprom_init();
+
     /* init led handler */
     led_init();
 
     /* init lcd display */
     tft_init();
 
+    /* on screen diagnostics */
+    console_init(&user_console);
+
     /* initialize the encoder */
-    rencoder_init(5, (EEPROM_SIZE - 16) / 16);
+    encoder_init();
+
+    /* input to display latency histograms */
+    latency_init();
+
+    /* run time statistics */
+    stats_init();
+    stats_register_queue(dma_request_queue, "dma");
 
     /* create the tasks specific to this application. */
-    xTaskCreate(led_run,      "led",          configMINIMAL_STACK_SIZE,     NULL, 3, NULL);
-    xTaskCreate(tft_run,      "tft",          configMINIMAL_STACK_SIZE*2,   NULL, 2, NULL);
-    xTaskCreate(dma_run,      "dma",          configMINIMAL_STACK_SIZE*2,   NULL, 2, NULL);
-    xTaskCreate(user_handler, "user_handler", configMINIMAL_STACK_SIZE*2,   NULL, 2, NULL);
-    xTaskCreate(rencoder_run, "rencoder",     configMINIMAL_STACK_SIZE,     NULL, 2, NULL);
+    MEM_TASK_CREATE(led_run,      "led",          LED_STACK_WORDS,      NULL, 3);
+    MEM_TASK_CREATE(tft_run,      "tft",          TFT_STACK_WORDS,      NULL, 2);
+    MEM_TASK_CREATE(fb_flush_run, "flush",        FLUSH_STACK_WORDS,    NULL, 3);
+    MEM_TASK_CREATE(dma_run,      "dma",          DMA_STACK_WORDS,      NULL, 2);
+    MEM_TASK_CREATE(user_handler, "user_handler", USER_STACK_WORDS,     NULL, 2);
+    MEM_TASK_CREATE(stats_run,    "stats",        STATS_STACK_WORDS,    NULL, 1);
+    MEM_TASK_CREATE(console_run,  "console",      CONSOLE_STACK_WORDS,  NULL, 1);
+#if ENCODER_TIMER
+    MEM_TASK_CREATE(encoder_run,  "encoder",      ENCODER_STACK_WORDS,  NULL, 2);
+#endif
 
     /* start the scheduler. */
     vTaskStartScheduler();
@@ -0,0 +1,60 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* allocation of the kernel objects: 0 creates them on the FreeRTOS heap, 1 in static buffers
+   sized at build time so that the map file shows all the ram that is used, in FreeRTOSConfig.h:
+       #define configSUPPORT_STATIC_ALLOCATION             1
+       #define configSUPPORT_DYNAMIC_ALLOCATION            0   (drops the heap, optional)
+   the memory budget of a build is listed from its map file with scripts/memmap.py (make memmap,
+   the sources need -fdata-sections) */
+#ifndef MEM_STATIC
+#define MEM_STATIC          0
+#endif
+
+/* buffer declarations at file scope (no trailing semicolon) and the matching creation,
+   the buffer names (<name>_stack, _tcb, _storage, _control) are the ones memmap.py reports */
+#if MEM_STATIC
+#define MEM_TASK(task, words)                                   static StackType_t task##_stack[words]; static StaticTask_t task##_tcb;
+#define MEM_TASK_CREATE(task, name, words, params, priority)    xTaskCreateStatic(task, name, words, params, priority, task##_stack, &task##_tcb)
+#define MEM_QUEUE(queue, length, size)                          static uint8_t queue##_storage[(length) * (size)]; static StaticQueue_t queue##_control;
+#define MEM_QUEUE_CREATE(queue, length, size)                   xQueueCreateStatic(length, size, queue##_storage, &queue##_control)
+#define MEM_MUTEX(mutex)                                        static StaticSemaphore_t mutex##_control;
+#define MEM_MUTEX_CREATE(mutex)                                 xSemaphoreCreateMutexStatic(&mutex##_control)
+#define MEM_SEMAPHORE(semaphore)                                static StaticSemaphore_t semaphore##_control;
+#define MEM_SEMAPHORE_CREATE(semaphore)                         xSemaphoreCreateBinaryStatic(&semaphore##_control)
+#else
+#define MEM_TASK(task, words)
+#define MEM_TASK_CREATE(task, name, words, params, priority)    xTaskCreate(task, name, words, params, priority, NULL)
+#define MEM_QUEUE(queue, length, size)
+#define MEM_QUEUE_CREATE(queue, length, size)                   xQueueCreate(length, size)
+#define MEM_MUTEX(mutex)
+#define MEM_MUTEX_CREATE(mutex)                                 xSemaphoreCreateMutex()
+#define MEM_SEMAPHORE(semaphore)
+#define MEM_SEMAPHORE_CREATE(semaphore)                         xSemaphoreCreateBinary()
+#endif
@@ -0,0 +1,151 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "semphr.h"
+#include "mem.h"
+#include "gpio.h"
+#include "spi.h"
+#include "system.h"
+#include "st7735.h"
+#include "panel.h"
+
+/* st7735 commands used for the direct memory access */
+#define PANEL_CMD_CASET     0x2A
+#define PANEL_CMD_RASET     0x2B
+#define PANEL_CMD_RAMWR     0x2C
+
+/* the st7735 driver has a single instance, it is bound to one panel at a time */
+static SemaphoreHandle_t panel_driver_lock = NULL;
+MEM_MUTEX(panel_driver_lock)
+static panel_t *panel_bound = NULL;
+
+static void panel_hw_res_high() { gpio_pin_high(&panel_bound->res); }
+static void panel_hw_res_low()  { gpio_pin_low(&panel_bound->res);  }
+static void panel_hw_dc_high()  { gpio_pin_high(&panel_bound->dc);  }
+static void panel_hw_dc_low()   { gpio_pin_low(&panel_bound->dc);   }
+
+static uint16_t panel_hw_data_wr(const uint8_t *buffer, uint16_t size, uint16_t repeat)
+{
+    return spi_bus_write(panel_bound->bus->spi, buffer, size, repeat);
+}
+
+static uint16_t panel_hw_data_rd(uint8_t *buffer, uint16_t size)
+{
+    return spi_bus_read(panel_bound->bus->spi, buffer, size);
+}
+
+void panel_bus_init(panel_bus_t *bus)
+{
+    spi_bus_init(bus->spi);
+#if MEM_STATIC
+    bus->lock = xSemaphoreCreateMutexStatic(&bus->lock_control);
+#else
+    bus->lock = xSemaphoreCreateMutex();
+#endif
+
+    if (panel_driver_lock == NULL) {
+        /* the callbacks forward to the panel that is bound at the moment */
+        st7735_hw_control_t hw = {
+            .res_high = panel_hw_res_high,
+            .res_low  = panel_hw_res_low,
+            .dc_high  = panel_hw_dc_high,
+            .dc_low   = panel_hw_dc_low,
+            .data_wr  = panel_hw_data_wr,
+            .data_rd  = panel_hw_data_rd,
+            .delay_us = delay_us
+        };
+
+        st7735_init(hw);
+        panel_driver_lock = MEM_MUTEX_CREATE(panel_driver_lock);
+    }
+}
+
+void panel_init(panel_t *panel)
+{
+    gpio_pin_init_output(&panel->dc);
+    gpio_pin_init_output(&panel->res);
+    gpio_pin_init_output(&panel->cs);
+
+    gpio_pin_high(&panel->cs);
+    gpio_pin_high(&panel->res);
+    gpio_pin_low(&panel->dc);
+}
+
+void panel_begin(panel_t *panel)
+{
+    xSemaphoreTake(panel->bus->lock, portMAX_DELAY);
+    gpio_pin_low(&panel->cs);
+}
+
+void panel_end(panel_t *panel)
+{
+    gpio_pin_high(&panel->cs);
+    xSemaphoreGive(panel->bus->lock);
+}
+
+void panel_command(panel_t *panel, uint8_t command, const uint8_t *data, uint16_t size)
+{
+    gpio_pin_low(&panel->dc);
+    spi_bus_write(panel->bus->spi, &command, 1, 1);
+    gpio_pin_high(&panel->dc);
+
+    if (size) {
+        spi_bus_write(panel->bus->spi, data, size, 1);
+    }
+}
+
+/* same addressing as the driver: one memory row per display x, the columns are the display y */
+void panel_set_window(panel_t *panel, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+    const uint8_t rows[4]    = { 0, x1, 0, x2 };
+    const uint8_t columns[4] = { 0, y1, 0, y2 };
+
+    panel_command(panel, PANEL_CMD_RASET, rows, sizeof(rows));
+    panel_command(panel, PANEL_CMD_CASET, columns, sizeof(columns));
+}
+
+void panel_memory_write(panel_t *panel, const uint8_t *data, uint16_t size, uint16_t repeat)
+{
+    panel_command(panel, PANEL_CMD_RAMWR, NULL, 0);
+    spi_bus_write(panel->bus->spi, data, size, repeat);
+}
+
+void panel_driver_bind(panel_t *panel)
+{
+    xSemaphoreTake(panel_driver_lock, portMAX_DELAY);
+    panel_begin(panel);
+    panel_bound = panel;
+}
+
+void panel_driver_release(panel_t *panel)
+{
+    panel_bound = NULL;
+    panel_end(panel);
+    xSemaphoreGive(panel_driver_lock);
+}
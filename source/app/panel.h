@@ -0,0 +1,68 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* panel_bus_t holds the semaphore buffer when MEM_STATIC is set, all the includers see one layout */
+#include "mem.h"
+
+/* spi bus shared by one or more panels */
+typedef struct panel_bus_t {
+    SPI_TypeDef *spi;
+    SemaphoreHandle_t lock;
+#if MEM_STATIC
+    StaticSemaphore_t lock_control;
+#endif
+} panel_bus_t;
+
+/* one st7735 panel with its own control pins */
+typedef struct panel_t {
+    panel_bus_t *bus;
+    gpio_pin_t dc;
+    gpio_pin_t res;
+    gpio_pin_t cs;
+} panel_t;
+
+/* initialization */
+void panel_bus_init(panel_bus_t *bus);
+void panel_init(panel_t *panel);
+
+/* exclusive access to the bus of the panel with the chip select active */
+void panel_begin(panel_t *panel);
+void panel_end(panel_t *panel);
+
+/* direct access to the panel memory (between begin/end), only the bus is locked: the frames of
+   panels on different buses are sent at the same time. the window uses the native orientation
+   of the panel, one memory row per display x: the data is sent x by x, each x from y1 to y2 */
+void panel_command(panel_t *panel, uint8_t command, const uint8_t *data, uint16_t size);
+void panel_set_window(panel_t *panel, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+void panel_memory_write(panel_t *panel, const uint8_t *data, uint16_t size, uint16_t repeat);
+
+/* route the st7735 driver (single instance) to the panel, for the commands that are not
+   available above (reset, configuration) */
+void panel_driver_bind(panel_t *panel);
+void panel_driver_release(panel_t *panel);
@@ -0,0 +1,97 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "task.h"
+#include "semphr.h"
+#include "mem.h"
+#include "pool.h"
+
+void pool_init(pool_t *pool, void *storage, uint16_t block_size, uint16_t count)
+{
+    uint8_t *block = storage;
+
+    pool->free = NULL;
+    for (uint16_t i = 0; i < count; i++) {
+        *(void **)&block[i * block_size] = pool->free;
+        pool->free = &block[i * block_size];
+    }
+    pool->count = count;
+    pool->min_free = count;
+
+    /* counts the free blocks, the allocation blocks on it when the pool is empty */
+#if MEM_STATIC
+    pool->available = xSemaphoreCreateCountingStatic(count, count, &pool->available_control);
+#else
+    pool->available = xSemaphoreCreateCounting(count, count);
+#endif
+}
+
+void *pool_alloc(pool_t *pool, TickType_t timeout)
+{
+    void *block;
+
+    if (xSemaphoreTake(pool->available, timeout) != pdTRUE) {
+        return NULL;
+    }
+
+    taskENTER_CRITICAL();
+    block = pool->free;
+    pool->free = *(void **)block;
+    uint16_t available = uxSemaphoreGetCount(pool->available);
+    if (available < pool->min_free) {
+        pool->min_free = available;
+    }
+    taskEXIT_CRITICAL();
+
+    return block;
+}
+
+void pool_free(pool_t *pool, void *block)
+{
+    if (block == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    *(void **)block = pool->free;
+    pool->free = block;
+    taskEXIT_CRITICAL();
+
+    xSemaphoreGive(pool->available);
+}
+
+uint16_t pool_available(pool_t *pool)
+{
+    return uxSemaphoreGetCount(pool->available);
+}
+
+uint16_t pool_min_available(pool_t *pool)
+{
+    return pool->min_free;
+}
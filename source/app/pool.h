@@ -0,0 +1,54 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* MEM_STATIC changes the size of pool_t */
+#include "mem.h"
+
+/* fixed block message pool, the blocks are handed over through pointer queues: the sender
+   allocates and fills a block, the receiver returns it once consumed. the free blocks are
+   linked through their first word, the block size must be a multiple of the pointer size */
+typedef struct pool_t {
+    void *free;
+    SemaphoreHandle_t available;
+#if MEM_STATIC
+    StaticSemaphore_t available_control;
+#endif
+    uint16_t count;
+    uint16_t min_free;
+} pool_t;
+
+void pool_init(pool_t *pool, void *storage, uint16_t block_size, uint16_t count);
+
+/* returns NULL if no block became free before the timeout */
+void *pool_alloc(pool_t *pool, TickType_t timeout);
+void pool_free(pool_t *pool, void *block);
+
+/* free blocks now and the lowest number seen since the start */
+uint16_t pool_available(pool_t *pool);
+uint16_t pool_min_available(pool_t *pool);
@@ -0,0 +1,97 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "semphr.h"
+#include "gpio.h"
+#include "st7735.h"
+#include "panel.h"
+#include "rgb444.h"
+
+/* pixels packed per memory write when drawing images (even number) */
+#define RGB444_IMAGE_PIXELS     256
+
+static uint8_t rgb444_buffer[(RGB444_IMAGE_PIXELS * 3) / 2];
+
+uint16_t rgb444_pack(const rgb444_t *src, uint16_t count, uint8_t *dst)
+{
+    rgb444_stream_t stream;
+
+    rgb444_stream_init(&stream, dst);
+    for (uint16_t i = 0; i < count; i++) {
+        rgb444_stream_put(&stream, src[i]);
+    }
+    return rgb444_stream_end(&stream);
+}
+
+uint16_t rgb444_pack_rgb565(const st7735_color_16_bit_t *src, uint16_t count, uint8_t *dst)
+{
+    rgb444_stream_t stream;
+
+    rgb444_stream_init(&stream, dst);
+    for (uint16_t i = 0; i < count; i++) {
+        rgb444_stream_put(&stream, rgb444_from_rgb565(src[i]));
+    }
+    return rgb444_stream_end(&stream);
+}
+
+void rgb444_draw_fill(panel_t *panel, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, st7735_color_16_bit_t color)
+{
+    const rgb444_t c = rgb444_from_rgb565(color);
+    const uint8_t pattern[3] = { c >> 4, (c << 4) | (c >> 8), c };
+    const uint32_t pixels = (uint32_t)(x2 - x1 + 1) * (y2 - y1 + 1);
+
+    /* an odd pixel count sends one more pixel of the same color, it wraps over the first one */
+    panel_set_window(panel, x1, y1, x2, y2);
+    panel_memory_write(panel, pattern, sizeof(pattern), (pixels + 1) / 2);
+}
+
+void rgb444_draw_image(panel_t *panel, uint8_t x, uint8_t y, uint8_t width, uint8_t height, const uint8_t *data)
+{
+    rgb444_stream_t stream;
+
+    if (width == 0 || height == 0) {
+        return;
+    }
+    const uint16_t columns = RGB444_IMAGE_PIXELS / height;
+
+    /* the image is stored row by row, it is sent x by x in chunks of full columns */
+    for (uint16_t i = 0; i < width; i += columns) {
+        uint16_t n = ((width - i) < columns) ? (width - i) : columns;
+
+        rgb444_stream_init(&stream, rgb444_buffer);
+        for (uint16_t cx = i; cx < i + n; cx++) {
+            for (uint16_t cy = 0; cy < height; cy++) {
+                rgb444_stream_put(&stream, rgb444_from_bytes(&data[(cy * width + cx) * 2]));
+            }
+        }
+
+        panel_set_window(panel, x + i, y, x + i + n - 1, y + height - 1);
+        panel_memory_write(panel, rgb444_buffer, rgb444_stream_end(&stream), 1);
+    }
+}
@@ -0,0 +1,92 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* 12 bit color 0x0RGB as sent to the display in ST7735_12_PIXEL mode */
+typedef uint16_t rgb444_t;
+
+/* packs a pixel stream, two pixels in three bytes: RG BR GB */
+typedef struct rgb444_stream_t {
+    uint8_t *buffer;
+    uint16_t length;
+    rgb444_t pending;
+    uint8_t odd;
+} rgb444_stream_t;
+
+/* conversion of a rgb565 pixel stored in the order it is sent to the display (msb first) */
+static inline rgb444_t rgb444_from_bytes(const uint8_t *c)
+{
+    return ((c[0] & 0xF0) << 4) | ((((c[0] & 0x07) << 1) | (c[1] >> 7)) << 4) | ((c[1] & 0x1E) >> 1);
+}
+
+static inline rgb444_t rgb444_from_rgb565(st7735_color_16_bit_t color)
+{
+    return rgb444_from_bytes((const uint8_t *)&color);
+}
+
+static inline void rgb444_stream_init(rgb444_stream_t *stream, uint8_t *buffer)
+{
+    stream->buffer = buffer;
+    stream->length = 0;
+    stream->odd = 0;
+}
+
+static inline void rgb444_stream_put(rgb444_stream_t *stream, rgb444_t color)
+{
+    if (stream->odd) {
+        uint8_t *p = &stream->buffer[stream->length];
+        p[0] = (uint8_t)(stream->pending >> 4);
+        p[1] = (uint8_t)((stream->pending << 4) | (color >> 8));
+        p[2] = (uint8_t)color;
+        stream->length += 3;
+    }
+    else {
+        stream->pending = color;
+    }
+    stream->odd ^= 1;
+}
+
+/* flushes a pending odd pixel and returns the number of bytes in the stream */
+static inline uint16_t rgb444_stream_end(rgb444_stream_t *stream)
+{
+    if (stream->odd) {
+        stream->buffer[stream->length++] = (uint8_t)(stream->pending >> 4);
+        stream->buffer[stream->length++] = (uint8_t)(stream->pending << 4);
+        stream->odd = 0;
+    }
+    return stream->length;
+}
+
+/* packing of rgb565 sources, returns the number of bytes written */
+uint16_t rgb444_pack(const rgb444_t *src, uint16_t count, uint8_t *dst);
+uint16_t rgb444_pack_rgb565(const st7735_color_16_bit_t *src, uint16_t count, uint8_t *dst);
+
+/* drawing with the display in ST7735_12_PIXEL mode, through the bus of the panel (between
+   panel_begin and panel_end) */
+void rgb444_draw_fill(panel_t *panel, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, st7735_color_16_bit_t color);
+void rgb444_draw_image(panel_t *panel, uint8_t x, uint8_t y, uint8_t width, uint8_t height, const uint8_t *data);
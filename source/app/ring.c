@@ -0,0 +1,127 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "string.h"
+#include "semphr.h"
+#include "ring.h"
+
+void ring_init(ring_t *ring, void *storage, uint16_t item_size, uint16_t items)
+{
+    ring->buffer = storage;
+    ring->item_size = item_size;
+    ring->mask = items - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+#if MEM_STATIC
+    ring->wake = xSemaphoreCreateBinaryStatic(&ring->wake_control);
+#else
+    ring->wake = xSemaphoreCreateBinary();
+#endif
+}
+
+uint16_t ring_count(const ring_t *ring)
+{
+    return (uint16_t)(ring->head - ring->tail);
+}
+
+/* copies the item and publishes it, returns pdTRUE if the consumer has to be woken */
+static BaseType_t ring_publish(ring_t *ring, const void *item, BaseType_t *stored)
+{
+    uint16_t head = ring->head;
+
+    if ((uint16_t)(head - ring->tail) > ring->mask) {
+        ring->dropped++;
+        *stored = pdFALSE;
+        return pdFALSE;
+    }
+    memcpy(&ring->buffer[(head & ring->mask) * ring->item_size], item, ring->item_size);
+
+    /* the item is in memory before the consumer can see the new head */
+    __DMB();
+    ring->head = head + 1;
+    __DMB();
+    *stored = pdTRUE;
+
+    /* the tail is read after the head is published: a consumer that found the ring empty
+       has either seen this item or gets the semaphore (a stale give costs it one more pass) */
+    return (uint16_t)(head + 1 - ring->tail) == 1;
+}
+
+BaseType_t ring_put(ring_t *ring, const void *item)
+{
+    BaseType_t stored;
+
+    if (ring_publish(ring, item, &stored)) {
+        xSemaphoreGive(ring->wake);
+    }
+    return stored;
+}
+
+BaseType_t ring_put_from_isr(ring_t *ring, const void *item, BaseType_t *woken)
+{
+    BaseType_t stored;
+
+    if (ring_publish(ring, item, &stored)) {
+        xSemaphoreGiveFromISR(ring->wake, woken);
+    }
+    return stored;
+}
+
+BaseType_t ring_get(ring_t *ring, void *item)
+{
+    uint16_t tail = ring->tail;
+
+    if (ring->head == tail) {
+        return pdFALSE;
+    }
+
+    /* the item is read after the head that published it, and before the slot is released */
+    __DMB();
+    memcpy(item, &ring->buffer[(tail & ring->mask) * ring->item_size], ring->item_size);
+    __DMB();
+    ring->tail = tail + 1;
+
+    /* the release is visible before the head is checked again (pairs with the producer wake test) */
+    __DMB();
+
+    return pdTRUE;
+}
+
+BaseType_t ring_receive(ring_t *ring, void *item, TickType_t timeout)
+{
+    for (;;) {
+        if (ring_get(ring, item) == pdTRUE) {
+            return pdTRUE;
+        }
+        if (xSemaphoreTake(ring->wake, timeout) != pdTRUE) {
+            return ring_get(ring, item);
+        }
+    }
+}
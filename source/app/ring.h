@@ -0,0 +1,63 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* ring_t holds the semaphore buffer when MEM_STATIC is set, all the includers see one layout */
+#include "mem.h"
+
+/* lock-free single producer / single consumer ring for interrupt to task delivery
+   the producer only writes the head, the consumer only writes the tail, both indexes run
+   free and are masked on access: the number of items has to be a power of two (at most 32768)
+   the consumer is woken through a binary semaphore given when the ring goes from empty to
+   non-empty, the task notifications stay free for the value based ones (dma_wait)
+   producers that share a ring must not pre-empt each other (interrupts of the same priority,
+   or a task that masks the interrupts around ring_put) */
+typedef struct ring_t {
+    uint8_t *buffer;
+    uint16_t item_size;
+    uint16_t mask;
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    volatile uint32_t dropped;
+    SemaphoreHandle_t wake;
+#if MEM_STATIC
+    StaticSemaphore_t wake_control;
+#endif
+} ring_t;
+
+void ring_init(ring_t *ring, void *storage, uint16_t item_size, uint16_t items);
+
+/* producer side, returns pdFALSE (and counts the item as dropped) if the ring is full */
+BaseType_t ring_put(ring_t *ring, const void *item);
+BaseType_t ring_put_from_isr(ring_t *ring, const void *item, BaseType_t *woken);
+
+/* consumer side, ring_receive blocks the calling task up to timeout while the ring is empty */
+BaseType_t ring_get(ring_t *ring, void *item);
+BaseType_t ring_receive(ring_t *ring, void *item, TickType_t timeout);
+
+uint16_t ring_count(const ring_t *ring);
@@ -0,0 +1,196 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stdint.h"
+#include "string.h"
+#include "sched.h"
+
+/* wrap around safe time comparison */
+static inline int32_t sched_diff(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b);
+}
+
+static uint8_t sched_device(sched_t *sched, uint8_t address)
+{
+    for (uint8_t i = 0; i < sched->devices; i++) {
+        if (sched->stats[i].address == address) {
+            return i;
+        }
+    }
+
+    /* devices past the table size share the last entry */
+    if (sched->devices == SCHED_DEVICES) {
+        return SCHED_DEVICES - 1;
+    }
+
+    sched->stats[sched->devices].address = address;
+    return sched->devices++;
+}
+
+static uint8_t sched_priority(const sched_slot_t *slot, uint32_t now)
+{
+    uint32_t promotion = (uint32_t)sched_diff(now, slot->enqueued) / SCHED_AGING_US;
+    return (promotion >= slot->priority) ? 0 : slot->priority - promotion;
+}
+
+/* returns 1 if a is to be served before b */
+static uint8_t sched_before(const sched_t *sched, const sched_slot_t *a, const sched_slot_t *b, uint32_t now)
+{
+    uint8_t pa = sched_priority(a, now);
+    uint8_t pb = sched_priority(b, now);
+    if (pa != pb) {
+        return pa < pb;
+    }
+
+    /* earliest latest-start-time first, transfers with a deadline go before the ones without */
+    if (a->has_deadline != b->has_deadline) {
+        return a->has_deadline;
+    }
+    if (a->has_deadline) {
+        int32_t d = sched_diff(a->deadline - a->cost, b->deadline - b->cost);
+        if (d != 0) {
+            return d < 0;
+        }
+    }
+
+    /* fairness between devices: the one that waited longest since its last transfer */
+    if (a->device != b->device) {
+        int32_t d = sched_diff(sched->last_service[a->device], sched->last_service[b->device]);
+        if (d != 0) {
+            return d < 0;
+        }
+    }
+
+    return sched_diff(a->sequence, b->sequence) < 0;
+}
+
+void sched_init(sched_t *sched, uint32_t bus_hz)
+{
+    memset(sched, 0, sizeof(sched_t));
+    sched->bus_hz = bus_hz;
+}
+
+int8_t sched_push(sched_t *sched, uint8_t address, uint8_t priority, uint32_t deadline_us, uint16_t bytes, uint32_t now)
+{
+    for (int8_t i = 0; i < SCHED_SLOTS; i++) {
+        sched_slot_t *slot = &sched->slot[i];
+        if (slot->state != sched_slot_free) {
+            continue;
+        }
+
+        slot->state = sched_slot_queued;
+        slot->priority = (priority < SCHED_PRIORITIES) ? priority : SCHED_PRIORITIES - 1;
+        slot->device = sched_device(sched, address);
+        slot->has_deadline = (deadline_us != SCHED_NO_DEADLINE);
+        slot->bytes = bytes;
+        slot->cost = sched_transfer_us(sched->bus_hz, bytes);
+        slot->sequence = sched->sequence++;
+        slot->enqueued = now;
+        slot->deadline = now + deadline_us;
+        return i;
+    }
+    return -1;
+}
+
+int8_t sched_pop(sched_t *sched, uint32_t now)
+{
+    int8_t next = -1;
+
+    for (int8_t i = 0; i < SCHED_SLOTS; i++) {
+        if (sched->slot[i].state != sched_slot_queued) {
+            continue;
+        }
+        if (next < 0 || sched_before(sched, &sched->slot[i], &sched->slot[next], now)) {
+            next = i;
+        }
+    }
+
+    if (next >= 0) {
+        sched->slot[next].state = sched_slot_active;
+        sched->slot[next].started = now;
+    }
+    return next;
+}
+
+void sched_done(sched_t *sched, int8_t slot, uint32_t now)
+{
+    sched_slot_t *s = &sched->slot[slot];
+    sched_stats_t *stats = &sched->stats[s->device];
+    uint32_t wait = s->started - s->enqueued;
+
+    stats->transfers++;
+    stats->bytes += s->bytes;
+    stats->busy_us += now - s->started;
+    stats->wait_us += wait;
+    if (wait > stats->wait_max_us) {
+        stats->wait_max_us = wait;
+    }
+    if (s->has_deadline && sched_diff(now, s->deadline) > 0) {
+        stats->deadline_misses++;
+    }
+
+    sched->last_service[s->device] = now;
+    s->state = sched_slot_free;
+}
+
+uint8_t sched_queued(const sched_t *sched)
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < SCHED_SLOTS; i++) {
+        count += (sched->slot[i].state == sched_slot_queued);
+    }
+    return count;
+}
+
+uint8_t sched_full(const sched_t *sched)
+{
+    for (uint8_t i = 0; i < SCHED_SLOTS; i++) {
+        if (sched->slot[i].state == sched_slot_free) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+const sched_stats_t *sched_stats(const sched_t *sched, uint8_t address)
+{
+    for (uint8_t i = 0; i < sched->devices; i++) {
+        if (sched->stats[i].address == address) {
+            return &sched->stats[i];
+        }
+    }
+    return 0;
+}
+
+uint32_t sched_transfer_us(uint32_t bus_hz, uint16_t bytes)
+{
+    uint32_t clocks = 2 + 9 * (1 + (uint32_t)bytes);
+
+    /* 64 bit, clocks * 1000000 no longer fits in 32 bit above about 470 bytes */
+    return (uint32_t)(((uint64_t)clocks * 1000000UL + bus_hz - 1) / bus_hz);
+}
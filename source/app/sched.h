@@ -0,0 +1,94 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* i2c bus scheduling policy, plain C without rtos or hardware dependencies
+   priority 0 is served first, within a priority the earliest deadline wins, then the device
+   that was served least recently; waiting requests are promoted one priority every SCHED_AGING_US */
+#define SCHED_SLOTS         16
+#define SCHED_PRIORITIES    3
+#define SCHED_DEVICES       4
+#define SCHED_AGING_US      50000
+#define SCHED_NO_DEADLINE   0
+
+typedef enum {
+    sched_slot_free,
+    sched_slot_queued,
+    sched_slot_active
+} sched_slot_state_t;
+
+/* per device statistics, times in us */
+typedef struct sched_stats_t {
+    uint8_t address;
+    uint32_t transfers;
+    uint32_t bytes;
+    uint32_t busy_us;
+    uint32_t wait_us;
+    uint32_t wait_max_us;
+    uint32_t deadline_misses;
+} sched_stats_t;
+
+typedef struct sched_slot_t {
+    sched_slot_state_t state;
+    uint8_t priority;
+    uint8_t device;
+    uint8_t has_deadline;
+    uint16_t bytes;
+    uint32_t cost;
+    uint32_t sequence;
+    uint32_t enqueued;
+    uint32_t started;
+    uint32_t deadline;
+} sched_slot_t;
+
+typedef struct sched_t {
+    uint32_t bus_hz;
+    uint32_t sequence;
+    uint8_t devices;
+    sched_slot_t slot[SCHED_SLOTS];
+    sched_stats_t stats[SCHED_DEVICES];
+    uint32_t last_service[SCHED_DEVICES];
+} sched_t;
+
+void sched_init(sched_t *sched, uint32_t bus_hz);
+
+/* queue a transfer, returns the slot or -1 if all slots are in use */
+int8_t sched_push(sched_t *sched, uint8_t address, uint8_t priority, uint32_t deadline_us, uint16_t bytes, uint32_t now);
+
+/* select the next transfer, returns the slot or -1 if nothing is queued */
+int8_t sched_pop(sched_t *sched, uint32_t now);
+
+/* release the slot of a finished transfer and account for it */
+void sched_done(sched_t *sched, int8_t slot, uint32_t now);
+
+uint8_t sched_queued(const sched_t *sched);
+uint8_t sched_full(const sched_t *sched);
+const sched_stats_t *sched_stats(const sched_t *sched, uint8_t address);
+
+/* bus time of a transfer: start, address byte, data bytes and stop, 9 clocks per byte */
+uint32_t sched_transfer_us(uint32_t bus_hz, uint16_t bytes);
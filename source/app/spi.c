@@ -21,73 +21,206 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 05.Oct.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
 #include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "task.h"
+#include "semphr.h"
+#include "mem.h"
+#include "trace.h"
+#include "gpio.h"
 #include "spi.h"
 
+/* transmit dma of a bus, each bus has its own stream so that the buses send in parallel:
+   SPI1_TX is DMA2 stream 3 channel 3, SPI2_TX is DMA1 stream 4 channel 0 */
+typedef struct spi_dma_t {
+    DMA_Stream_TypeDef *stream;
+    uint32_t channel;
+    volatile uint32_t *status;
+    volatile uint32_t *clear;
+    uint32_t done_flags;
+    uint32_t clear_flags;
+    SemaphoreHandle_t done;
+} spi_dma_t;
+
+static spi_dma_t spi1_dma = {
+    .stream      = DMA2_Stream3,
+    .channel     = DMA_SxCR_CHSEL_0 | DMA_SxCR_CHSEL_1,
+    .status      = &DMA2->LISR,
+    .clear       = &DMA2->LIFCR,
+    .done_flags  = DMA_LISR_TCIF3 | DMA_LISR_TEIF3,
+    .clear_flags = DMA_LIFCR_CTCIF3 | DMA_LIFCR_CHTIF3 | DMA_LIFCR_CTEIF3 | DMA_LIFCR_CDMEIF3 | DMA_LIFCR_CFEIF3
+};
+MEM_SEMAPHORE(spi1_dma_done)
+
+static spi_dma_t spi2_dma = {
+    .stream      = DMA1_Stream4,
+    .channel     = 0,
+    .status      = &DMA1->HISR,
+    .clear       = &DMA1->HIFCR,
+    .done_flags  = DMA_HISR_TCIF4 | DMA_HISR_TEIF4,
+    .clear_flags = DMA_HIFCR_CTCIF4 | DMA_HIFCR_CHTIF4 | DMA_HIFCR_CTEIF4 | DMA_HIFCR_CDMEIF4 | DMA_HIFCR_CFEIF4
+};
+MEM_SEMAPHORE(spi2_dma_done)
+
+static inline spi_dma_t *spi_dma(SPI_TypeDef *spi)
+{
+    return (spi == SPI1) ? &spi1_dma : ((spi == SPI2) ? &spi2_dma : NULL);
+}
+
+static void spi_dma_init(spi_dma_t *dma, SPI_TypeDef *spi)
+{
+    /* make sure the stream is disabled */
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_EN_Msk, 0);
+    do {
+    } while ((dma->stream->CR & DMA_SxCR_EN_Msk) != 0);
+
+    /* select the channel of the SPI TX, memory to peripheral */
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_CHSEL_Msk, dma->channel);
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_DIR_Msk, DMA_SxCR_DIR_0);
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_PSIZE_Msk, 0);                 // 8 bit
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_PINC_Msk,  0);                 // no increment
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_MSIZE_Msk, 0);                 // 8 bit
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_MINC_Msk,  DMA_SxCR_MINC);     // increment
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_PL_Msk, DMA_SxCR_PL_1);
+    dma->stream->PAR = (uint32_t)&spi->DR;
+
+    /* enable interupts */
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_TCIE_Msk | DMA_SxCR_TEIE_Msk, DMA_SxCR_TCIE | DMA_SxCR_TEIE);
+}
+
 void spi_init()
 {
-    MODIFY_REG(SPI1->CR1, SPI_CR1_CPHA_Msk, 0);                       /* CPOL = 0, CPHA = 0 */
-    MODIFY_REG(SPI1->CR1, SPI_CR1_CPOL_Msk, 0);
-    MODIFY_REG(SPI1->CR1, SPI_CR1_MSTR_Msk, SPI_CR1_MSTR);            /* MASTER */
-    MODIFY_REG(SPI1->CR1, SPI_CR1_BR_Msk, 0x02 << SPI_CR1_BR_Pos);    /* 48Mhz / 2 = 24Mhz (41.67ns) */
-    MODIFY_REG(SPI1->CR1, SPI_CR1_LSBFIRST_Msk, 0);                   /* MSB First */
-    MODIFY_REG(SPI1->CR1, SPI_CR1_BIDIMODE_Msk, SPI_CR1_BIDIMODE);    /* BI Directional - MOSI */
-    MODIFY_REG(SPI1->CR1, SPI_CR1_BIDIOE_Msk, SPI_CR1_BIDIOE);        /* BI Directional - transmit only */
-
-    MODIFY_REG(SPI1->CR2, SPI_CR2_SSOE_Msk, SPI_CR2_SSOE);            /* single master */
+    spi_bus_init(SPI1);
+    spi_dma_init(&spi1_dma, SPI1);
+    spi1_dma.done = MEM_SEMAPHORE_CREATE(spi1_dma_done);
 }
 
-uint16_t spi_write(const uint8_t *buffer, uint16_t size, uint16_t repeat)
+void spi_bus_init(SPI_TypeDef *spi)
 {
+    /* SPI1 and its pins are set up by system_init and gpio_init */
+    if (spi == SPI2) {
+        SET_BIT(RCC->APB1ENR, RCC_APB1ENR_SPI2EN);
+        gpio_spi2_init();
+
+        /* the transmit stream is on DMA1 next to the I2C streams, both dma clocks are on */
+        spi_dma_init(&spi2_dma, SPI2);
+        spi2_dma.done = MEM_SEMAPHORE_CREATE(spi2_dma_done);
+    }
+
+    MODIFY_REG(spi->CR1, SPI_CR1_CPHA_Msk, 0);                       /* CPOL = 0, CPHA = 0 */
+    MODIFY_REG(spi->CR1, SPI_CR1_CPOL_Msk, 0);
+    MODIFY_REG(spi->CR1, SPI_CR1_MSTR_Msk, SPI_CR1_MSTR);            /* MASTER */
+    MODIFY_REG(spi->CR1, SPI_CR1_BR_Msk, 0x02 << SPI_CR1_BR_Pos);    /* 48Mhz / 2 = 24Mhz (41.67ns) */
+    MODIFY_REG(spi->CR1, SPI_CR1_LSBFIRST_Msk, 0);                   /* MSB First */
+    MODIFY_REG(spi->CR1, SPI_CR1_BIDIMODE_Msk, SPI_CR1_BIDIMODE);    /* BI Directional - MOSI */
+    MODIFY_REG(spi->CR1, SPI_CR1_BIDIOE_Msk, SPI_CR1_BIDIOE);        /* BI Directional - transmit only */
+
+    MODIFY_REG(spi->CR1, SPI_CR1_SSM_Msk | SPI_CR1_SSI_Msk, SPI_CR1_SSM | SPI_CR1_SSI);  /* chip select per panel as gpio */
+}
+
+static void spi_bus_write_dma(SPI_TypeDef *spi, spi_dma_t *dma, const uint8_t *buffer, uint16_t size)
+{
+    /* the stream is started first, the spi requests the bytes once TXDMAEN is set */
+    *dma->clear = dma->clear_flags;
+    dma->stream->M0AR = (uint32_t)buffer;
+    dma->stream->NDTR = size;
+    MODIFY_REG(dma->stream->CR, DMA_SxCR_EN_Msk, DMA_SxCR_EN);
+    MODIFY_REG(spi->CR2, SPI_CR2_TXDMAEN_Msk, SPI_CR2_TXDMAEN);
+
+    /* the task sleeps while the bytes are on the wire, a stuck stream is stopped */
+    if (xSemaphoreTake(dma->done, SPI_DMA_TIMEOUT_MS(size) / portTICK_PERIOD_MS + 1) != pdTRUE) {
+        MODIFY_REG(dma->stream->CR, DMA_SxCR_EN_Msk, 0);
+        do {
+        } while ((dma->stream->CR & DMA_SxCR_EN_Msk) != 0);
+        xSemaphoreTake(dma->done, 0);
+    }
+    MODIFY_REG(spi->CR2, SPI_CR2_TXDMAEN_Msk, 0);
+}
+
+void spi_isr_dma_tx_handler(SPI_TypeDef *spi)
+{
+    BaseType_t woken = pdFALSE;
+    spi_dma_t *dma = spi_dma(spi);
+
+    if (*dma->status & dma->done_flags) {
+        *dma->clear = dma->clear_flags;
+        xSemaphoreGiveFromISR(dma->done, &woken);
+    }
+
+    portYIELD_FROM_ISR(woken);
+}
+
+uint16_t spi_bus_write(SPI_TypeDef *spi, const uint8_t *buffer, uint16_t size, uint16_t repeat)
+{
+    TRACE_SPI_BEGIN((spi == SPI1) ? 1 : 2, size * repeat);
+
     /* set the SPI in transmit only mode */
-    MODIFY_REG(SPI1->CR1, SPI_CR1_BIDIOE_Msk, SPI_CR1_BIDIOE);
+    MODIFY_REG(spi->CR1, SPI_CR1_BIDIOE_Msk, SPI_CR1_BIDIOE);
 
     /* activate the SPI */
-    MODIFY_REG(SPI1->CR1, SPI_CR1_SPE_Msk, SPI_CR1_SPE);
-
-    for (uint16_t j = 0; j < repeat; j++) {
-        for (uint16_t i = 0; i < size; i++) {
-            /* wait for TX ready and load the data */
-            do {
-            } while ((SPI1->SR & SPI_SR_TXE_Msk) != SPI_SR_TXE);
-            SPI1->DR = buffer[i];
+    MODIFY_REG(spi->CR1, SPI_CR1_SPE_Msk, SPI_CR1_SPE);
+
+    /* large buffers go with dma once the scheduler runs, the rest (commands, fills) byte by byte */
+    spi_dma_t *dma = spi_dma(spi);
+    if (dma != NULL && dma->done != NULL && repeat == 1 && size >= SPI_DMA_MIN_SIZE && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        spi_bus_write_dma(spi, dma, buffer, size);
+    }
+    else {
+        for (uint16_t j = 0; j < repeat; j++) {
+            for (uint16_t i = 0; i < size; i++) {
+                /* wait for TX ready and load the data */
+                do {
+                } while ((spi->SR & SPI_SR_TXE_Msk) != SPI_SR_TXE);
+                spi->DR = buffer[i];
+            }
         }
     }
 
     /* wait for TX ready, wait for busy flag to be reseted and then disable the SPI */
     do {
-    } while ((SPI1->SR & SPI_SR_TXE_Msk) != SPI_SR_TXE);
+    } while ((spi->SR & SPI_SR_TXE_Msk) != SPI_SR_TXE);
     do {
-    } while ((SPI1->SR & SPI_SR_BSY_Msk) == SPI_SR_BSY);
-    MODIFY_REG(SPI1->CR1, SPI_CR1_SPE_Msk, 0);
+    } while ((spi->SR & SPI_SR_BSY_Msk) == SPI_SR_BSY);
+    MODIFY_REG(spi->CR1, SPI_CR1_SPE_Msk, 0);
 
+    TRACE_SPI_END((spi == SPI1) ? 1 : 2, size * repeat);
     return size;
 }
 
-uint16_t spi_read(uint8_t *buffer, uint16_t size)
+uint16_t spi_bus_read(SPI_TypeDef *spi, uint8_t *buffer, uint16_t size)
 {
     /* set the SPI in receive only mode */
-    MODIFY_REG(SPI1->CR1, SPI_CR1_BIDIOE_Msk, 0);
+    MODIFY_REG(spi->CR1, SPI_CR1_BIDIOE_Msk, 0);
 
     /* activate the SPI */
-    MODIFY_REG(SPI1->CR1, SPI_CR1_SPE_Msk, SPI_CR1_SPE);
+    MODIFY_REG(spi->CR1, SPI_CR1_SPE_Msk, SPI_CR1_SPE);
 
     for (uint16_t i = 0; i < size; i++) {
         /* disable the SPI */
         if (i == (size - 1)) {
-            MODIFY_REG(SPI1->CR1, SPI_CR1_SPE_Msk, 0);
+            MODIFY_REG(spi->CR1, SPI_CR1_SPE_Msk, 0);
         }
 
         /* wait for data */
         do {
-        } while ((SPI1->SR & SPI_SR_RXNE_Msk) != SPI_SR_RXNE);
+        } while ((spi->SR & SPI_SR_RXNE_Msk) != SPI_SR_RXNE);
 
-        buffer[i] = SPI1->DR;
+        buffer[i] = spi->DR;
     }
 
     return size;
-}
\ No newline at end of file
+}
+
+uint16_t spi_write(const uint8_t *buffer, uint16_t size, uint16_t repeat)
+{
+    return spi_bus_write(SPI1, buffer, size, repeat);
+}
+
+uint16_t spi_read(uint8_t *buffer, uint16_t size)
+{
+    return spi_bus_read(SPI1, buffer, size);
+}
@@ -21,14 +21,29 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 20.Sep.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
  
 #pragma once
 
+/* writes of at least this size are sent with the transmit dma of the bus while the task sleeps
+   (SPI1: DMA2 stream 3, SPI2: DMA1 stream 4) */
+#define SPI_DMA_MIN_SIZE            32
+
+/* about 3000 bytes per ms at 24MHz plus margin */
+#define SPI_DMA_TIMEOUT_MS(size)    (2 + (size) / 3000)
+
 void spi_init();
+void spi_bus_init(SPI_TypeDef *spi);
+
+/* read/write on a given bus */
+uint16_t spi_bus_write(SPI_TypeDef *spi, const uint8_t *buffer, uint16_t size, uint16_t repeat);
+uint16_t spi_bus_read(SPI_TypeDef *spi, uint8_t *buffer, uint16_t size);
+
+/* transfer complete of the transmit dma of a bus */
+void spi_isr_dma_tx_handler(SPI_TypeDef *spi);
 
-/* basic read/write */
+/* basic read/write (SPI1) */
 uint16_t spi_write(const uint8_t *buffer, uint16_t size, uint16_t repeat);
 uint16_t spi_read(uint8_t *buffer, uint16_t size);
\ No newline at end of file
@@ -0,0 +1,183 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "stdarg.h"
+#include "task.h"
+#include "queue.h"
+#include "system.h"
+#include "isr.h"
+#include "gpio.h"
+#include "latency.h"
+#include "trace.h"
+#include "sched.h"
+#include "dma.h"
+#include "st7735.h"
+#include "panel.h"
+#include "fb.h"
+#include "update.h"
+#include "tft.h"
+#include "printf.h"
+#include "stats.h"
+
+typedef struct stats_queue_t {
+    QueueHandle_t queue;
+    const char *name;
+    UBaseType_t peak;
+} stats_queue_t;
+
+static stats_queue_t stats_queue[STATS_QUEUES];
+static uint8_t stats_queues = 0;
+
+#if (configUSE_TRACE_FACILITY == 1) && (configGENERATE_RUN_TIME_STATS == 1)
+static TaskStatus_t stats_task[STATS_TASKS];
+
+/* run time of each task at the previous report, indexed by the task number */
+static uint32_t stats_run_time[STATS_TASKS];
+#endif
+
+void stats_init()
+{
+    stats_queues = 0;
+}
+
+void stats_register_queue(QueueHandle_t queue, const char *name)
+{
+    if (stats_queues < STATS_QUEUES) {
+        stats_queue[stats_queues].queue = queue;
+        stats_queue[stats_queues].name = name;
+        stats_queue[stats_queues].peak = 0;
+        stats_queues++;
+    }
+}
+
+/* the occupancy reached by the item about to be queued, capped at the length of the queue: a
+   sender blocked on a full queue reaches the length once it gets through */
+void stats_queue_send(QueueHandle_t queue)
+{
+    for (uint8_t i = 0; i < stats_queues; i++) {
+        if (stats_queue[i].queue == queue) {
+            taskENTER_CRITICAL();
+            UBaseType_t waiting = uxQueueMessagesWaiting(queue);
+            if (uxQueueSpacesAvailable(queue) > 0) {
+                waiting++;
+            }
+            if (waiting > stats_queue[i].peak) {
+                stats_queue[i].peak = waiting;
+            }
+            taskEXIT_CRITICAL();
+            return;
+        }
+    }
+}
+
+static void stats_print(const char *format, ...)
+{
+    char txt[48];
+    va_list va;
+
+    va_start(va, format);
+    int length = vsnprintf(txt, sizeof(txt), format, va);
+    va_end(va);
+
+    if (length > (int)sizeof(txt) - 1) {
+        length = sizeof(txt) - 1;
+    }
+    _write(0, txt, length);
+}
+
+/* one report, one line per record:
+       S <uptime ms> <period cycles>
+       T <name> <cpu per mille> <free stack words>
+       Q <name> <peak> <length>
+       H <free heap bytes> <minimum ever free heap bytes>
+   followed by the i2c devices (see dma_report), the display updates (see tft_report), the frame
+   times (see fb_report) and the interrupt profile (see isr_report) */
+static void stats_report(uint32_t period)
+{
+    stats_print("S %lu %lu\n", (unsigned long)(xTaskGetTickCount() * portTICK_PERIOD_MS), (unsigned long)period);
+
+#if (configUSE_TRACE_FACILITY == 1) && (configGENERATE_RUN_TIME_STATS == 1)
+    UBaseType_t tasks = uxTaskGetSystemState(stats_task, STATS_TASKS, NULL);
+    for (UBaseType_t i = 0; i < tasks; i++) {
+        TaskStatus_t *task = &stats_task[i];
+        uint32_t run_time = 0;
+
+        if (task->xTaskNumber < STATS_TASKS) {
+            run_time = task->ulRunTimeCounter - stats_run_time[task->xTaskNumber];
+            stats_run_time[task->xTaskNumber] = task->ulRunTimeCounter;
+        }
+        stats_print("T %s %lu %u\n", task->pcTaskName,
+                    (unsigned long)(period ? (uint64_t)run_time * 1000 / period : 0),
+                    (unsigned)task->usStackHighWaterMark);
+    }
+#endif
+
+    for (uint8_t i = 0; i < stats_queues; i++) {
+        stats_queue_t *queue = &stats_queue[i];
+        UBaseType_t length = uxQueueSpacesAvailable(queue->queue) + uxQueueMessagesWaiting(queue->queue);
+        taskENTER_CRITICAL();
+        UBaseType_t peak = queue->peak;
+        queue->peak = uxQueueMessagesWaiting(queue->queue);
+        taskEXIT_CRITICAL();
+        stats_print("Q %s %u %u\n", queue->name, (unsigned)peak, (unsigned)length);
+    }
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+    /* heap left now and at its lowest, what is never used can be given back to the static buffers */
+    stats_print("H %lu %lu\n", (unsigned long)xPortGetFreeHeapSize(), (unsigned long)xPortGetMinimumEverFreeHeapSize());
+#endif
+
+    /* i2c throughput and waiting time per device */
+    dma_report();
+
+    /* display updates merged into frames and the frame times */
+    tft_report();
+    fb_report();
+
+    /* interrupt handler durations and the priority ordering they suggest */
+    isr_report();
+}
+
+void stats_run(void *pvParameters)
+{
+    (void)pvParameters;
+    uint32_t start = system_cycles();
+
+    for (;;) {
+        /* the trace records left in the buffer when the events stop go out here */
+        for (uint16_t i = 0; i < STATS_PERIOD_MS / TRACE_FLUSH_MS; i++) {
+            vTaskDelay(TRACE_FLUSH_MS / portTICK_PERIOD_MS);
+            trace_flush();
+        }
+
+        uint32_t now = system_cycles();
+        stats_report(now - start);
+        start = now;
+    }
+}
@@ -0,0 +1,47 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* run time statistics: cpu load and stack high water mark per task, queue occupancy peaks
+   the cpu load needs the run time counter of the kernel on the DWT cycle counter, in FreeRTOSConfig.h:
+       #define configUSE_TRACE_FACILITY                    1
+       #define configGENERATE_RUN_TIME_STATS               1
+       #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+       #define portGET_RUN_TIME_COUNTER_VALUE()            (DWT->CYCCNT)
+   the counter wraps after about 44s at 96MHz, the report period has to stay below that */
+#define STATS_PERIOD_MS     2000
+#define STATS_TASKS         10
+#define STATS_QUEUES        6
+
+void stats_init();
+void stats_run(void *pvParameters);
+
+/* queues whose occupancy peak is reported, the senders call stats_queue_send before each
+   send so that the peak is the highest occupancy reached, not a sample of it */
+void stats_register_queue(QueueHandle_t queue, const char *name);
+void stats_queue_send(QueueHandle_t queue);
@@ -21,7 +21,7 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 24.Jan.2021  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
@@ -87,6 +87,7 @@ void system_init()
     SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIOCEN);
     SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIOHEN);
     SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_DMA1EN);
+    SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_DMA2EN);
 
     /* enable APB1 devices */
     SET_BIT(RCC->APB1ENR, RCC_APB1ENR_I2C1EN);
@@ -102,6 +103,11 @@ void system_init()
 
     /* stop timer when debuggng */
     SET_BIT(DBGMCU->APB2FZ, DBGMCU_APB2_FZ_DBG_TIM10_STOP);
+
+    /* cycle counter for time stamps */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 /**
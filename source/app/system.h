@@ -21,7 +21,7 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 13.Jan.2021  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
@@ -30,3 +30,12 @@
 void system_init();
 void delay_us(const uint32_t us);
 void blink(const uint8_t n);
+
+/* ITM text output (stimulus port 0) */
+int _write(int file, char *ptr, int len);
+
+/* DWT cycle counter, enabled in system_init */
+static inline uint32_t system_cycles()
+{
+    return DWT->CYCCNT;
+}
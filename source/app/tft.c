@@ -21,397 +21,195 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 08.Oct.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
 #include "stm32f4xx.h"
 #include "stm32rtos.h"
-#include "stdlib.h"
 #include "string.h"
 #include "queue.h"
+#include "semphr.h"
+#include "mem.h"
 #include "gpio.h"
 #include "system.h"
+#include "trace.h"
+#include "latency.h"
+#include "update.h"
+#include "frame.h"
 #include "tft.h"
 #include "spi.h"
 #include "st7735.h"
+#include "panel.h"
+#include "rgb444.h"
+#include "fb.h"
 #include "printf.h"
 
-extern const struct {
-  unsigned int 	 width;
-  unsigned int 	 height;
-  unsigned char	 pixel_data[];
-} mario;
-
-extern const struct {
-  unsigned int 	 width;
-  unsigned int 	 height;
-  unsigned char	 pixel_data[];
-} plant;
-
-extern const struct {
-  unsigned int 	 width;
-  unsigned int 	 height;
-  unsigned char	 pixel_data[];
-} logo;
-
 extern const uint8_t u8x8_font_8x13B_1x2_f[];
 
- /* Queue used to communicate TFT update messages. */
-QueueHandle_t tft_queue = NULL;
+/* the update being collected and the one being drawn, swapped under the lock by the tft task */
+typedef struct tft_update_t {
+    update_t update;
+    latency_trace_t trace;
+} tft_update_t;
+
+static tft_update_t tft_updates[2];
+static tft_update_t *tft_pending = &tft_updates[0];
+static SemaphoreHandle_t tft_update_lock = NULL;
+MEM_MUTEX(tft_update_lock)
+static TaskHandle_t tft_task = NULL;
+
+/* frame pacing on a microsecond clock kept from the cycle counter */
+static frame_t tft_frame;
+static uint32_t tft_clock_us = 0;
+static uint32_t tft_clock_cycles = 0;
+
+/* counters since the last report */
+static struct {
+    uint32_t posted;
+    uint32_t frames;
+    uint32_t rows;
+} tft_update_stats;
+
+/* the display on SPI1 */
+static panel_bus_t tft_bus = { .spi = SPI1 };
+static panel_t tft_panel = {
+    .bus = &tft_bus,
+    .dc  = { GPIOA, 6 },
+    .res = { GPIOA, 3 },
+    .cs  = { GPIOA, 4 }
+};
 
 void tft_init()
 {
-    tft_queue = xQueueCreate(6, sizeof(tft_event_t));
-}
-
-void tft_run_(void *params)
-{
-    (void)params;
-    char display_txt[6][17] = { 0 };
-    st7735_color_16_bit_t bk_colors[] = {
-        st7735_rgb_yellow,
-        st7735_rgb_lime,
-        st7735_rgb_teal
-    };
-    uint8_t bk_color_index = 0;
-
-    st7735_hw_control_t hw = {
-        .res_high = gpio_tft_res_high,
-        .res_low  = gpio_tft_res_low,
-        .dc_high  = gpio_tft_dc_high,
-        .dc_low   = gpio_tft_dc_low,
-        .data_wr  = spi_write,
-        .data_rd  = spi_read,
-        .delay_us = delay_us
-    };
-
-    st7735_init(hw);
-
-    /* perform a HW reset */
-    st7735_hardware_reset();
-    st7735_sleep_out_and_booster_on();
-    delay_us(10000);
-    st7735_normal_mode();
-
-    /* configure the display */
-    st7735_display_inversion_off();
-    st7735_interface_pixel_format(ST7735_16_PIXEL);
-    st7735_display_on();
-    st7735_memory_data_access_control(0, 1, 0, 0, 0, 0);
-    st7735_column_address_set(0, 128-1);
-    st7735_row_address_set(0, 160-1);
-
-    /* prepare the background */
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-    st7735_draw_rectangle(10, 10, 150, 120, st7735_rgb_red, bk_colors[bk_color_index]);
-
-    /* process events */
-    for (;;) {
-        tft_event_t tft_event;
-        if (xQueueReceive(tft_queue, &tft_event, portMAX_DELAY) == pdPASS) {
-            switch (tft_event.type) {
-                case tft_event_text_up:
-                    memcpy(display_txt[0], display_txt[1], 17);
-                    memcpy(display_txt[1], display_txt[2], 17);
-                    memcpy(display_txt[2], display_txt[3], 17);
-                    memcpy(display_txt[3], display_txt[4], 17);
-                    memcpy(display_txt[4], display_txt[5], 17);
-                    memcpy(display_txt[5], tft_event.row_txt, 17);
-                    
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 2*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[0]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 4*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[1]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 6*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[2]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 8*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[3]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8,10*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[4]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8,12*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[5]);
-                    break;
-
-                case tft_event_text_down:
-                    memcpy(display_txt[5], display_txt[4], 17);
-                    memcpy(display_txt[4], display_txt[3], 17);
-                    memcpy(display_txt[3], display_txt[2], 17);
-                    memcpy(display_txt[2], display_txt[1], 17);
-                    memcpy(display_txt[1], display_txt[0], 17);
-                    memcpy(display_txt[0], tft_event.row_txt, 17);
-                    
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 2*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[0]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 4*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[1]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 6*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[2]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 8*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[3]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8,10*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[4]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8,12*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[5]);
-                    break;
-                
-                case tft_event_background:
-                    bk_color_index++;
-                    if (bk_color_index >= sizeof(bk_colors)/sizeof(st7735_color_16_bit_t)) {
-                        bk_color_index = 0;
-                    }
-
-                    /* prepare the background */
-                    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-                    st7735_draw_rectangle(10, 10, 150, 120, st7735_rgb_red, bk_colors[bk_color_index]);
-
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 2*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[0]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 4*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[1]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 6*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[2]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 8*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[3]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8,10*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[4]);
-                    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8,12*8, st7735_rgb_black, bk_colors[bk_color_index], display_txt[5]);
-                    break;
-                
-                default:
-                    break;
-            }
-        }
-    }
+    update_clear(&tft_updates[0].update);
+    update_clear(&tft_updates[1].update);
+    frame_init(&tft_frame, TFT_FRAME_PERIOD_US, TFT_FRAME_BUDGET_US);
+    tft_update_lock = MEM_MUTEX_CREATE(tft_update_lock);
+
+    panel_bus_init(&tft_bus);
+    panel_init(&tft_panel);
+    fb_init(&tft_panel);
 }
 
-static void test_draw_display_id()
+/* only called by the tft task, a wrap of the cycle counter while it sleeps shortens the idle time,
+   which the pacing does not depend on */
+static uint32_t tft_now_us()
 {
-    char txt[16] = { 0 };
-    uint32_t id;
-    uint8_t id1, id2, id3;
-
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-    vTaskDelay(500 / portTICK_PERIOD_MS);
-
-    st7735_read_display_id(&id);
-    sprintf(txt, "ID:  0x%08X", id);
-    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 2*8, st7735_rgb_black, st7735_rgb_white, txt);
-
-    st7735_read_id1(&id1);
-    sprintf(txt, "ID1: 0x%02X", id1);
-    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 5*8, st7735_rgb_black, st7735_rgb_white, txt);
-
-    st7735_read_id2(&id2);
-    sprintf(txt, "ID2: 0x%02X", id2);
-    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 8*8, st7735_rgb_black, st7735_rgb_white, txt);
+    const uint32_t cycles_per_us = configCPU_CLOCK_HZ / 1000000;
+    uint32_t elapsed = system_cycles() - tft_clock_cycles;
 
-    st7735_read_id3(&id3);
-    sprintf(txt, "ID3: 0x%02X", id3);
-    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 11*8, st7735_rgb_black, st7735_rgb_white, txt);
-
-    st7735_display_inversion_on();
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    st7735_display_inversion_off();
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    st7735_display_inversion_on();
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    st7735_display_inversion_off();
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    tft_clock_us += elapsed / cycles_per_us;
+    tft_clock_cycles += (elapsed / cycles_per_us) * cycles_per_us;
+    return tft_clock_us;
 }
 
-static void test_draw_fill()
+/* the merged update keeps the oldest encoder edge, its latency is the one the user sees */
+static void tft_post_trace(const latency_trace_t *trace)
 {
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-    for (uint16_t i = 0; i < 50; i++) {
-        st7735_color_16_bit_t color = { ST7735_RGB(0, 0, i*5) };
-        st7735_draw_fill(i, i, 160-1-i, 128-1-i, color);
-    }
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-    for (uint16_t i = 0; i < 50; i++) {
-        st7735_color_16_bit_t color = { ST7735_RGB(0, i*5, 0) };
-        st7735_draw_fill(i, i, 160-1-i, 128-1-i, color);
-    }
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-    for (uint16_t i = 0; i < 50; i++) {
-        st7735_color_16_bit_t color = { ST7735_RGB(i*5, 0, 0) };
-        st7735_draw_fill(i, i, 160-1-i, 128-1-i, color);
+    if (trace != NULL && trace->edge) {
+        if (!tft_pending->trace.edge || (int32_t)(trace->edge - tft_pending->trace.edge) < 0) {
+            tft_pending->trace = *trace;
+        }
     }
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
 }
 
-static void test_draw_region()
+static void tft_post_done()
 {
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    st7735_draw_fill(20, 20, 140, 110, st7735_rgb_red);
-    st7735_draw_fill(30, 30, 50, 50, st7735_rgb_blue);
-    st7735_draw_fill(80, 80,  100, 100, st7735_rgb_cyan);
-    st7735_draw_fill(60, 30,  90, 90, st7735_rgb_green);
-
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-}
-
-static void test_draw_filled_rectangle()
-{
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    st7735_draw_rectangle(40, 32, 120, 96, st7735_rgb_red, st7735_rgb_yellow);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    st7735_draw_rectangle(10, 15, 50, 78, st7735_rgb_red, st7735_rgb_cyan);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    st7735_draw_rectangle(60, 70, 143, 100, st7735_rgb_red, st7735_rgb_lime);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    xSemaphoreGive(tft_update_lock);
+    if (tft_task != NULL) {
+        xTaskNotifyGive(tft_task);
+    }
 }
 
-static void test_draw_lines()
+void tft_post_scroll(int8_t direction, const char *row_txt, const latency_trace_t *trace)
 {
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-    for (uint8_t i = 0; i < 160; i++) {
-        if (i < 128) {
-            st7735_draw_h_line(0, 160-1, i, st7735_rgb_red);
-        }
-        st7735_draw_v_line(0, 128-1, i, st7735_rgb_blue);
-        vTaskDelay(10 / portTICK_PERIOD_MS);
-    }
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-    for (uint8_t i = 0; i < 160; i++) {
-        st7735_draw_line(0, 0, i, 128-1, st7735_rgb_red);
-    }
-    for (uint8_t i = 128; i > 0; i--) {
-        st7735_draw_line(0, 0, 160-1, i-1, st7735_rgb_red);
-    }
-
-    for (uint8_t i = 0; i < 160; i++) {
-        st7735_draw_line(0, 128-1, i, 0, st7735_rgb_blue);
-    }
-    for (uint8_t i = 0; i < 128; i++) {
-        st7735_draw_line(0, 128-1, 160-1, i, st7735_rgb_blue);
-    }
-
-    for (uint8_t i = 160; i > 0; i--) {
-        st7735_draw_line(160-1, 0, i-1, 128-1, st7735_rgb_green);
-    }
-    for (uint8_t i = 128; i > 0; i--) {
-        st7735_draw_line(160-1, 0, 0, i-1, st7735_rgb_green);
-    }
-
-    for (uint8_t i = 160; i > 0; i--) {
-        st7735_draw_line(160-1, 128-1, i-1, 0, st7735_rgb_yellow);
-    }
-    for (uint8_t i = 0; i < 128; i++) {
-        st7735_draw_line(160-1, 128-1, 0, i, st7735_rgb_yellow);
-    }
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    TRACE_QUEUE_SEND(trace_queue_tft, (direction > 0) ? tft_event_text_up : tft_event_text_down);
+    xSemaphoreTake(tft_update_lock, portMAX_DELAY);
+    update_scroll(&tft_pending->update, direction, row_txt);
+    tft_post_trace(trace);
+    tft_post_done();
 }
 
-static void test_draw_circles()
+void tft_post_rows(const char rows_txt[TFT_ROWS][17], const latency_trace_t *trace)
 {
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-
-    st7735_draw_fill_circle(50, 50, 30, st7735_rgb_green);
-    st7735_draw_fill_circle(100, 50, 10, st7735_rgb_yellow);
-    st7735_draw_fill_circle(80, 80, 15, st7735_rgb_red);
-    st7735_draw_fill_circle(70, 20, 20, st7735_rgb_blue);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    st7735_draw_circle(50, 50, 30, st7735_rgb_black);
-    st7735_draw_circle(100, 50, 10, st7735_rgb_black);
-    st7735_draw_circle(80, 80, 15, st7735_rgb_black);
-    st7735_draw_circle(70, 20, 20, st7735_rgb_black);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    TRACE_QUEUE_SEND(trace_queue_tft, tft_event_text_jump);
+    xSemaphoreTake(tft_update_lock, portMAX_DELAY);
+    update_rows(&tft_pending->update, rows_txt);
+    tft_post_trace(trace);
+    tft_post_done();
 }
 
-static void test_draw_image()
+void tft_post_background()
 {
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_black);
-    st7735_draw_image(0, 0, logo.width, logo.height, (uint8_t *)logo.pixel_data);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    TRACE_QUEUE_SEND(trace_queue_tft, tft_event_background);
+    xSemaphoreTake(tft_update_lock, portMAX_DELAY);
+    update_background(&tft_pending->update);
+    tft_post_done();
 }
 
-static uint8_t read_buffer[128*3] = { 0 };
-static st7735_color_16_bit_t write_buffer[128];
-static void test_draw_read_write()
+void tft_report()
 {
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_black);
-    st7735_draw_image(0, 0, logo.width, logo.height, (uint8_t *)logo.pixel_data);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-
-    for (uint8_t i = 0; i < 160; i++) {
-        st7735_interface_pixel_format(ST7735_18_PIXEL);
-        st7735_row_address_set(i, i);
-        st7735_column_address_set(0, 128 - 1);
-        st7735_memory_read(read_buffer, sizeof(read_buffer));
-        st7735_interface_pixel_format(ST7735_16_PIXEL);
-
-        vTaskDelay(10 / portTICK_PERIOD_MS);
-        for (uint8_t j = 0; j < 128; j++) {
-            st7735_color_16_bit_t color =  { ST7735_RGB_18bit((255 - read_buffer[j*3+1]), (255 - read_buffer[j*3+2]), (255 - read_buffer[j*3]))  };
-            write_buffer[j] = color;
-        }
-
-        st7735_row_address_set(i, i);
-        st7735_column_address_set(0, 128 - 1);
-        st7735_memory_write(write_buffer, sizeof(write_buffer), 1);
+    char txt[80];
+    uint32_t posted, frames, rows;
+    frame_stats_t pacing;
+    frame_quality_t quality;
+
+    taskENTER_CRITICAL();
+    posted = tft_update_stats.posted;
+    frames = tft_update_stats.frames;
+    rows = tft_update_stats.rows;
+    memset(&tft_update_stats, 0, sizeof(tft_update_stats));
+    pacing = tft_frame.stats;
+    quality = frame_quality(&tft_frame);
+    memset(&tft_frame.stats, 0, sizeof(frame_stats_t));
+    taskEXIT_CRITICAL();
+
+    if (posted) {
+        int length = snprintf(txt, sizeof(txt), "U %lu %lu %lu\n", (unsigned long)posted, (unsigned long)frames, (unsigned long)rows);
+        _write(0, txt, length);
     }
 
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-}
-
-static void test_draw_text()
-{
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-    vTaskDelay(500 / portTICK_PERIOD_MS);
-
-    st7735_draw_string(u8x8_font_8x13B_1x2_f, 2*8, 7*8, st7735_rgb_black, st7735_rgb_white, "Text: ");
-    for (int i = 0; i < 2500; i++) {
-        char txt[5] = { 0, 0, 0, 0, 0};
-        itoa(i, txt, 10);
-        st7735_draw_string(u8x8_font_8x13B_1x2_f, 9*8, 7*8, st7735_rgb_black, st7735_rgb_white, txt);
+    if (pacing.frames == 0) {
+        return;
     }
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
+
+    int length = snprintf(txt, sizeof(txt), "R %lu %lu %lu %lu %lu %lu %lu %u\n", (unsigned long)pacing.frames,
+                          (unsigned long)(pacing.time / pacing.frames), (unsigned long)pacing.time_max,
+                          (unsigned long)pacing.missed, (unsigned long)pacing.over, (unsigned long)pacing.skipped,
+                          (unsigned long)pacing.degraded, (unsigned)quality);
+    _write(0, txt, length);
 }
 
-static void test_draw_animation()
+/* the rows are a ring, top is the index of the row shown first, only the rows in the mask are drawn */
+static uint8_t tft_draw_rows(char display_txt[TFT_ROWS][17], uint8_t top, uint8_t rows)
 {
-    uint8_t mario_x = 0, mario_y = 90;
-
-    st7735_draw_fill(0, 0, 160-1, 128-1, st7735_rgb_white);
-    st7735_draw_image(78, mario_y + mario.height - plant.height, plant.width, plant.height, (uint8_t *)plant.pixel_data);
+    uint8_t drawn = 0;
 
-    while (mario_x <= (160 - mario.width - 1)) {
-        st7735_draw_fill(mario_x, mario_y, mario_x + mario.width-1, mario_y + mario.height-1, st7735_rgb_white);
-        mario_x++;
-        if (mario_x >= 30 && mario_x < 35) {
-            mario_y -= 3;
+    TRACE_DRAW_BEGIN(trace_draw_rows);
+    for (uint8_t i = 0; i < TFT_ROWS; i++) {
+        if (rows & (1 << i)) {
+            fb_draw_string(u8x8_font_8x13B_1x2_f, 2*8, (1 + 2*i)*8, tft_color_black, tft_color_background, display_txt[(top + i) % TFT_ROWS]);
+            drawn++;
         }
-
-        if (mario_x >= 35 && mario_x < 40) {
-            mario_y += 3;
-        }
-
-        if (mario_x >= 60 && mario_x < 81) {
-            mario_y -= 3;
-        }
-
-        if (mario_x >= 81 && mario_x < 102) {
-            mario_y += 3;
-        }
-
-        st7735_draw_image(mario_x, mario_y, mario.width, mario.height, (uint8_t *)mario.pixel_data);
-        vTaskDelay(30 / portTICK_PERIOD_MS);
     }
+    TRACE_DRAW_END(trace_draw_rows);
+    return drawn;
 }
 
 void tft_run(void *params)
 {
     (void)params;
-
-    st7735_hw_control_t hw = {
-        .res_high = gpio_tft_res_high,
-        .res_low  = gpio_tft_res_low,
-        .dc_high  = gpio_tft_dc_high,
-        .dc_low   = gpio_tft_dc_low,
-        .data_wr  = spi_write,
-        .data_rd  = spi_read,
-        .delay_us = delay_us
+    char display_txt[TFT_ROWS][17] = { 0 };
+    uint8_t display_top = 0;
+    st7735_color_16_bit_t bk_colors[] = {
+        st7735_rgb_yellow,
+        st7735_rgb_lime,
+        st7735_rgb_teal
     };
+    uint8_t bk_color_index = 0;
 
-    st7735_init(hw);
+    panel_driver_bind(&tft_panel);
 
     /* perform a HW reset */
     st7735_hardware_reset();
@@ -421,55 +219,96 @@ void tft_run(void *params)
 
     /* configure the display */
     st7735_display_inversion_off();
+#if FB_RGB444
+    st7735_interface_pixel_format(ST7735_12_PIXEL);
+#else
     st7735_interface_pixel_format(ST7735_16_PIXEL);
+#endif
     st7735_display_on();
     st7735_memory_data_access_control(0, 1, 0, 0, 0, 0);
     st7735_column_address_set(0, 128-1);
     st7735_row_address_set(0, 160-1);
- 
-    uint8_t all = 0;
+    panel_driver_release(&tft_panel);
+
+    /* set up the palette */
+    fb_lock();
+    fb_set_palette(tft_color_white, st7735_rgb_white);
+    fb_set_palette(tft_color_black, st7735_rgb_black);
+    fb_set_palette(tft_color_red, st7735_rgb_red);
+    fb_set_palette(tft_color_background, bk_colors[bk_color_index]);
+
+    /* prepare the background, the panel is cleared with a solid fill and only the frame of the
+       text rows is sent as pixels. the console task has a lower priority, it draws its line
+       after this first frame */
+    fb_clear(tft_color_white);
+    fb_draw_rectangle(10, 2, 150, 109, tft_color_red, tft_color_background);
+    fb_flush();
+    fb_unlock();
+
+    /* process the updates once per frame slot: everything posted since the last frame was merged
+       into one pending update, only the rows that end up different are drawn and the frame is sent
+       by the flush task while the next updates are collected */
+    tft_task = xTaskGetCurrentTaskHandle();
+    uint8_t bk_deferred = 0;
     for (;;) {
-        //goto draw_read_write;
-        all = 1;
-
-draw_display_id:
-        test_draw_display_id();
-        if (!all) continue;
-
-draw_fill:
-        test_draw_fill();
-        if (!all) continue;
-
-draw_region:
-        test_draw_region();
-        if (!all) continue;
-
-draw_filled_rectangle:
-        test_draw_filled_rectangle();
-        if (!all) continue;
-
-draw_lines:
-        test_draw_lines();
-        if (!all) continue;
-
-draw_circles:
-        test_draw_circles();
-        if (!all) continue;
-   
-draw_image:
-        test_draw_image();
-        if (!all) continue;
-
-draw_read_write:
-        test_draw_read_write();
-        if (!all) continue;
-
-draw_text:
-        test_draw_text();        
-        if (!all) continue;
-
-draw_animation:
-        test_draw_animation();        
-        if (!all) continue;
+        tft_update_t *pending;
+
+        /* tft_pending only changes below, the count is read without the lock */
+        if (tft_pending->update.posted == 0 && bk_deferred == 0) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        /* the updates posted until the slot starts are merged as well */
+        uint32_t wait = frame_wait(&tft_frame, tft_now_us());
+        if (wait) {
+            vTaskDelay((wait + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000));
+        }
+        frame_begin(&tft_frame, tft_now_us());
+
+        xSemaphoreTake(tft_update_lock, portMAX_DELAY);
+        pending = tft_pending;
+        tft_pending = (pending == &tft_updates[0]) ? &tft_updates[1] : &tft_updates[0];
+        xSemaphoreGive(tft_update_lock);
+        TRACE_QUEUE_RECEIVE(trace_queue_tft, pending->update.posted);
+
+        latency_trace_t trace = pending->trace;
+        if (trace.edge) {
+            trace.received = system_cycles();
+            latency_record(latency_stage_queue, trace.sent, trace.received);
+        }
+
+        /* the background steps add up, a full cycle leaves nothing to repaint. at minimal quality
+           the repaint waits, the text comes first */
+        bk_deferred = (bk_deferred + pending->update.background) % (sizeof(bk_colors)/sizeof(st7735_color_16_bit_t));
+        uint8_t bk_steps = (frame_quality(&tft_frame) == frame_quality_minimal) ? 0 : bk_deferred;
+        uint8_t rows = update_apply(&pending->update, display_txt, &display_top);
+
+        fb_lock();
+        uint8_t drawn = tft_draw_rows(display_txt, display_top, rows);
+
+        /* the repaint covers the rows, they are sent once with the new palette */
+        if (bk_steps) {
+            bk_color_index = (bk_color_index + bk_steps) % (sizeof(bk_colors)/sizeof(st7735_color_16_bit_t));
+            fb_set_palette(tft_color_background, bk_colors[bk_color_index]);
+            fb_invalidate(10, 2, 150, 109);
+            bk_deferred = 0;
+        }
+
+        /* the draw and total latency are recorded by the flush task once the frame is sent */
+        if (rows || bk_steps) {
+            fb_flush_traced(&trace);
+        }
+        fb_unlock();
+
+        taskENTER_CRITICAL();
+        frame_end(&tft_frame, tft_now_us());
+        tft_update_stats.posted += pending->update.posted;
+        tft_update_stats.frames += (rows || bk_steps) ? 1 : 0;
+        tft_update_stats.rows += drawn;
+        taskEXIT_CRITICAL();
+
+        update_clear(&pending->update);
+        pending->trace = (latency_trace_t){ 0 };
     }
-}
\ No newline at end of file
+}
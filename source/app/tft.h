@@ -21,30 +21,51 @@
  | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
  |____________________________________________________________________________|
  |                                                                            |
- |  Author: Mihai Baneu                           Last modified: 05.Oct.2022  |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
  |                                                                            |
  |___________________________________________________________________________*/
 
 #pragma once
 
+/* update kinds, as they appear in the trace */
 typedef enum tft_event_type_t {
     tft_event_text_up    = 0,
     tft_event_text_down  = 1,
-    tft_event_background = 2
+    tft_event_background = 2,
+    tft_event_text_jump  = 3
 } tft_event_type_t;
 
-/* tft update event */
-typedef struct tft_event_t {
-    union {
-        struct {
-            char row_txt[17];
-        };
-    };
-    tft_event_type_t type;
-} tft_event_t;
+/* palette indexes used by the framebuffer */
+enum {
+    tft_color_white,
+    tft_color_black,
+    tft_color_red,
+    tft_color_background
+};
 
-/* Queue used to communicate TFT update messages. */
-extern QueueHandle_t tft_queue;
+/* number of text rows on the display, the pending updates are merged by rows (see update.h) */
+#define TFT_ROWS    UPDATE_ROWS
+
+/* frame pacing (see frame.h): the target period and the time a frame may take to render and
+   hand over to the flush task, including the wait for a free band while the bus is busy */
+#ifndef TFT_FRAME_PERIOD_US
+#define TFT_FRAME_PERIOD_US     20000
+#endif
+
+#ifndef TFT_FRAME_BUDGET_US
+#define TFT_FRAME_BUDGET_US     16000
+#endif
 
 void tft_init();
+
+/* the updates are posted without waiting for the display: the ones posted while the tft task is
+   busy are merged into a single pending update and drawn together in the next frame */
+void tft_post_scroll(int8_t direction, const char *row_txt, const latency_trace_t *trace);
+void tft_post_rows(const char rows_txt[TFT_ROWS][17], const latency_trace_t *trace);
+void tft_post_background();
 void tft_run(void *);
+
+/* prints the counters since the last call:
+       U <posted> <frames drawn> <rows drawn>
+       R <frames> <avg us> <max us> <missed deadlines> <over budget> <skipped slots> <degraded> <quality> */
+void tft_report();
@@ -0,0 +1,103 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "task.h"
+#include "trace.h"
+
+/* records waiting for the ITM FIFO, head and tail run freely and wrap with the 16 bit type */
+static uint32_t trace_buffer[TRACE_BUFFER_WORDS];
+static uint16_t trace_head = 0;
+static uint16_t trace_tail = 0;
+static uint32_t trace_lost = 0;
+
+void trace_init()
+{
+    /* the debugger enables ITM and configures SWO, only the stimulus port is enabled here */
+    ITM->LAR = 0xC5ACCE55;
+    ITM->TER |= (1UL << TRACE_ITM_PORT);
+}
+
+static inline void trace_put(uint32_t word0, uint32_t word1, uint32_t word2, uint32_t word3)
+{
+    trace_buffer[trace_head++ & (TRACE_BUFFER_WORDS - 1)] = word0;
+    trace_buffer[trace_head++ & (TRACE_BUFFER_WORDS - 1)] = word1;
+    trace_buffer[trace_head++ & (TRACE_BUFFER_WORDS - 1)] = word2;
+    trace_buffer[trace_head++ & (TRACE_BUFFER_WORDS - 1)] = word3;
+}
+
+/* the port reads non zero while the FIFO takes a word */
+static inline void trace_drain()
+{
+    while (trace_tail != trace_head && ITM->PORT[TRACE_ITM_PORT].u32 != 0) {
+        ITM->PORT[TRACE_ITM_PORT].u32 = trace_buffer[trace_tail++ & (TRACE_BUFFER_WORDS - 1)];
+    }
+}
+
+static inline uint8_t trace_enabled()
+{
+    return (ITM->TCR & ITM_TCR_ITMENA_Msk) != 0 && (ITM->TER & (1UL << TRACE_ITM_PORT)) != 0;
+}
+
+void trace_event(trace_event_t event, uint32_t arg0, uint32_t arg1)
+{
+    if (!trace_enabled()) {
+        return;
+    }
+
+    /* the buffer is shared by tasks and interrupts, the mask only covers the time of the copy
+       and of the words the FIFO takes without waiting */
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    uint16_t space = TRACE_BUFFER_WORDS - (uint16_t)(trace_head - trace_tail);
+    uint16_t needed = (trace_lost > 0) ? 8 : 4;
+
+    if (space < needed) {
+        trace_lost++;
+    }
+    else {
+        uint32_t cycles = DWT->CYCCNT;
+        if (trace_lost > 0) {
+            trace_put((TRACE_SYNC << 24) | trace_records_lost, cycles, trace_lost, 0);
+            trace_lost = 0;
+        }
+        trace_put((TRACE_SYNC << 24) | event, cycles, arg0, arg1);
+    }
+    trace_drain();
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+void trace_flush()
+{
+    if (!trace_enabled()) {
+        return;
+    }
+
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    trace_drain();
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
@@ -0,0 +1,97 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* binary trace over ITM: every event is a record of four 32 bit writes to TRACE_ITM_PORT
+       word 0: TRACE_SYNC << 24 | event id
+       word 1: DWT cycle counter
+       word 2: first argument
+       word 3: second argument
+   records are dropped while the debugger has not enabled the port, scripts/trace.py decodes
+   a captured SWO stream
+   trace_event never waits for the ITM FIFO: the record goes to a ram buffer that is written to
+   the port as far as the FIFO takes it, by the next events and by trace_flush; a record that
+   does not fit is dropped and the count of dropped records is sent ahead of the next record */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE        1
+#endif
+
+/* words of the ram buffer, a power of two */
+#ifndef TRACE_BUFFER_WORDS
+#define TRACE_BUFFER_WORDS  256
+#endif
+
+/* period of trace_flush in the stats task */
+#define TRACE_FLUSH_MS      10
+
+#define TRACE_ITM_PORT      1
+#define TRACE_SYNC          0xA5
+
+/* event ids, keep in sync with scripts/trace.py */
+typedef enum {
+    trace_spi_write_begin   = 0x0001,   /* bus (1 = SPI1), bytes */
+    trace_spi_write_end     = 0x0002,   /* bus, bytes */
+    trace_dma_complete      = 0x0010,   /* request id, status */
+    trace_queue_send        = 0x0020,   /* queue, event type */
+    trace_queue_receive     = 0x0021,   /* queue, event type */
+    trace_draw_begin        = 0x0030,   /* primitive, 0 */
+    trace_draw_end          = 0x0031,   /* primitive, 0 */
+    trace_records_lost      = 0x0040,   /* records dropped since the previous record, 0 */
+} trace_event_t;
+
+/* queue and draw primitive arguments */
+typedef enum {
+    trace_queue_tft,
+    trace_queue_encoder,
+    trace_queue_dma
+} trace_queue_t;
+
+typedef enum {
+    trace_draw_rows,
+    trace_draw_flush
+} trace_draw_t;
+
+void trace_init();
+void trace_event(trace_event_t event, uint32_t arg0, uint32_t arg1);
+
+/* writes what the ITM FIFO takes of the buffered records, never waits */
+void trace_flush();
+
+#if TRACE_ENABLE
+#define TRACE(event, arg0, arg1)        trace_event((event), (uint32_t)(arg0), (uint32_t)(arg1))
+#else
+#define TRACE(event, arg0, arg1)
+#endif
+
+#define TRACE_SPI_BEGIN(bus, bytes)     TRACE(trace_spi_write_begin, (bus), (bytes))
+#define TRACE_SPI_END(bus, bytes)       TRACE(trace_spi_write_end, (bus), (bytes))
+#define TRACE_DMA_COMPLETE(id, status)  TRACE(trace_dma_complete, (id), (status))
+#define TRACE_QUEUE_SEND(queue, type)   TRACE(trace_queue_send, (queue), (type))
+#define TRACE_QUEUE_RECEIVE(queue, type) TRACE(trace_queue_receive, (queue), (type))
+#define TRACE_DRAW_BEGIN(primitive)     TRACE(trace_draw_begin, (primitive), 0)
+#define TRACE_DRAW_END(primitive)       TRACE(trace_draw_end, (primitive), 0)
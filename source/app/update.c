@@ -0,0 +1,111 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stdint.h"
+#include "string.h"
+#include "update.h"
+
+void update_clear(update_t *update)
+{
+    memset(update, 0, sizeof(update_t));
+}
+
+void update_scroll(update_t *update, int8_t direction, const char *row_txt)
+{
+    uint8_t position;
+
+    /* the pending rows move with the text, the one leaving the screen is dropped */
+    if (direction > 0) {
+        update->top = (update->top + 1) % UPDATE_ROWS;
+        update->rows >>= 1;
+        position = UPDATE_ROWS - 1;
+    }
+    else {
+        update->top = (update->top + UPDATE_ROWS - 1) % UPDATE_ROWS;
+        update->rows = (update->rows << 1) & UPDATE_ALL_ROWS;
+        position = 0;
+    }
+
+    /* padded with zeros so that identical rows compare equal */
+    char *txt = update->rows_txt[(update->top + position) % UPDATE_ROWS];
+    strncpy(txt, row_txt, UPDATE_ROW_SIZE - 1);
+    txt[UPDATE_ROW_SIZE - 1] = 0;
+
+    update->rows |= 1 << position;
+    update->scroll += direction;
+    update->posted++;
+}
+
+void update_rows(update_t *update, const char rows_txt[UPDATE_ROWS][UPDATE_ROW_SIZE])
+{
+    /* every row is replaced, the scrolls before it no longer matter */
+    for (uint8_t i = 0; i < UPDATE_ROWS; i++) {
+        strncpy(update->rows_txt[i], rows_txt[i], UPDATE_ROW_SIZE - 1);
+        update->rows_txt[i][UPDATE_ROW_SIZE - 1] = 0;
+    }
+    update->top = 0;
+    update->rows = UPDATE_ALL_ROWS;
+    update->scroll = 0;
+    update->posted++;
+}
+
+void update_background(update_t *update)
+{
+    update->background++;
+    update->posted++;
+}
+
+uint8_t update_apply(const update_t *update, char display_txt[UPDATE_ROWS][UPDATE_ROW_SIZE], uint8_t *display_top)
+{
+    uint8_t old_top = *display_top;
+    uint8_t new_top = old_top;
+    uint8_t changed = 0;
+
+    /* a full set of rows makes the scroll irrelevant */
+    if (update->rows != UPDATE_ALL_ROWS) {
+        int16_t shift = update->scroll % UPDATE_ROWS;
+        new_top = (old_top + UPDATE_ROWS + shift) % UPDATE_ROWS;
+    }
+
+    /* compare first, the ring entries written below are still needed as the old text of other rows */
+    for (uint8_t i = 0; i < UPDATE_ROWS; i++) {
+        const char *txt = (update->rows & (1 << i)) ? update->rows_txt[(update->top + i) % UPDATE_ROWS]
+                                                    : display_txt[(new_top + i) % UPDATE_ROWS];
+        if (memcmp(txt, display_txt[(old_top + i) % UPDATE_ROWS], UPDATE_ROW_SIZE) != 0) {
+            changed |= 1 << i;
+        }
+    }
+
+    for (uint8_t i = 0; i < UPDATE_ROWS; i++) {
+        if (update->rows & (1 << i)) {
+            memcpy(display_txt[(new_top + i) % UPDATE_ROWS], update->rows_txt[(update->top + i) % UPDATE_ROWS], UPDATE_ROW_SIZE);
+        }
+    }
+
+    *display_top = new_top;
+    return changed;
+}
@@ -0,0 +1,58 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+/* display update merging, plain C without rtos or hardware dependencies
+   the updates posted while the display is busy fold into a single pending one: scrolls rotate the
+   pending rows and add up to a net scroll, a jump replaces all the rows and the background steps
+   add up. the rows are kept by screen position in a ring, like the display, with a mask of the
+   positions whose text is pending */
+#define UPDATE_ROWS         6
+#define UPDATE_ROW_SIZE     17
+#define UPDATE_ALL_ROWS     ((1u << UPDATE_ROWS) - 1)
+
+typedef struct update_t {
+    char rows_txt[UPDATE_ROWS][UPDATE_ROW_SIZE];
+    uint8_t top;
+    uint8_t rows;
+    int16_t scroll;
+    uint8_t background;
+    uint16_t posted;
+} update_t;
+
+void update_clear(update_t *update);
+
+/* direction 1 moves the text up and brings row_txt in at the bottom, -1 moves it down and brings
+   row_txt in at the top */
+void update_scroll(update_t *update, int8_t direction, const char *row_txt);
+void update_rows(update_t *update, const char rows_txt[UPDATE_ROWS][UPDATE_ROW_SIZE]);
+void update_background(update_t *update);
+
+/* applies the net scroll and the pending rows to the display ring, returns the mask of the screen
+   rows whose text differs from what was shown before */
+uint8_t update_apply(const update_t *update, char display_txt[UPDATE_ROWS][UPDATE_ROW_SIZE], uint8_t *display_top);
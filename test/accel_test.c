@@ -0,0 +1,175 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stdint.h"
+#include "stdlib.h"
+#include "accel.h"
+#include "test.h"
+
+#ifndef ACCEL_TRACE_DIR
+#define ACCEL_TRACE_DIR     "data/"
+#endif
+
+#define TRACE_EVENTS        64
+
+/* the curve of main.c, TFT_ROWS rows per detent above 25 detents/s */
+static const accel_stage_t user_accel_curve[] = {
+    {  0, 1 },
+    { 10, 4 },
+    { 25, 6 },
+};
+
+typedef struct trace_event_t {
+    uint32_t timestamp;
+    int32_t detents;
+    int32_t steps;
+} trace_event_t;
+
+typedef struct trace_t {
+    uint8_t events;
+    trace_event_t event[TRACE_EVENTS];
+} trace_t;
+
+/* summary of a replay */
+typedef struct replay_t {
+    int32_t detents;
+    int32_t steps;
+    int32_t gain_max;
+    uint8_t mismatches;
+} replay_t;
+
+static int trace_load(trace_t *trace, const char *name)
+{
+    char line[128];
+    FILE *file = fopen(name, "r");
+
+    trace->events = 0;
+    if (file == NULL) {
+        printf("  cannot open %s\n", name);
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL && trace->events < TRACE_EVENTS) {
+        trace_event_t *event = &trace->event[trace->events];
+        char *next;
+
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        event->timestamp = strtoul(line, &next, 10);
+        event->detents = strtol(next, &next, 10);
+        event->steps = strtol(next, &next, 10);
+        trace->events++;
+    }
+    fclose(file);
+    return trace->events;
+}
+
+static replay_t trace_replay(const trace_t *trace)
+{
+    replay_t replay = { 0 };
+    accel_t accel;
+
+    accel_init(&accel, user_accel_curve, sizeof(user_accel_curve) / sizeof(accel_stage_t));
+    for (uint8_t i = 0; i < trace->events; i++) {
+        const trace_event_t *event = &trace->event[i];
+        int32_t steps = accel_update(&accel, event->detents, event->timestamp);
+
+        if (steps != event->steps) {
+            printf("  %u ms: %d detents moved %d steps, expected %d\n",
+                   (unsigned)event->timestamp, (int)event->detents, (int)steps, (int)event->steps);
+            replay.mismatches++;
+        }
+        if (steps / event->detents > replay.gain_max) {
+            replay.gain_max = steps / event->detents;
+        }
+        replay.detents += event->detents;
+        replay.steps += steps;
+    }
+    return replay;
+}
+
+static void test_idle()
+{
+    accel_t accel;
+    accel_init(&accel, user_accel_curve, sizeof(user_accel_curve) / sizeof(accel_stage_t));
+
+    TEST_EQUAL(accel_update(&accel, 0, 100), 0);
+    TEST_EQUAL(accel_update(&accel, 1, 120), 1);
+    TEST_EQUAL(accel_update(&accel, 1, 140), 6);
+
+    /* a pause longer than ACCEL_IDLE_MS falls back to one row per detent */
+    TEST_EQUAL(accel_update(&accel, 1, 140 + ACCEL_IDLE_MS + 1), 1);
+}
+
+static void test_slow()
+{
+    trace_t trace;
+    TEST_CHECK(trace_load(&trace, ACCEL_TRACE_DIR "accel_slow.txt") > 0);
+
+    /* below 10 detents/s every detent moves exactly one row */
+    replay_t replay = trace_replay(&trace);
+    TEST_EQUAL(replay.mismatches, 0);
+    TEST_EQUAL(replay.steps, replay.detents);
+    TEST_EQUAL(replay.gain_max, 1);
+}
+
+static void test_spin()
+{
+    trace_t trace;
+    TEST_CHECK(trace_load(&trace, ACCEL_TRACE_DIR "accel_spin.txt") > 0);
+
+    /* the fast part of the spin moves a page per detent */
+    replay_t replay = trace_replay(&trace);
+    TEST_EQUAL(replay.mismatches, 0);
+    TEST_EQUAL(replay.gain_max, 6);
+    TEST_CHECK(replay.steps > 4 * replay.detents);
+}
+
+static void test_reverse()
+{
+    trace_t trace;
+    TEST_CHECK(trace_load(&trace, ACCEL_TRACE_DIR "accel_reverse.txt") > 0);
+
+    /* a reversal never carries the speed of the other direction */
+    replay_t replay = trace_replay(&trace);
+    TEST_EQUAL(replay.mismatches, 0);
+    for (uint8_t i = 1; i < trace.events; i++) {
+        if ((trace.event[i].detents > 0) != (trace.event[i - 1].detents > 0)) {
+            TEST_EQUAL(trace.event[i].steps, trace.event[i].detents);
+        }
+    }
+}
+
+int main()
+{
+    TEST_RUN(test_idle);
+    TEST_RUN(test_slow);
+    TEST_RUN(test_spin);
+    TEST_RUN(test_reverse);
+    return TEST_RESULT();
+}
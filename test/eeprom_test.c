@@ -0,0 +1,237 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "string.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "sched.h"
+#include "dma.h"
+#include "eeprom.h"
+#include "test.h"
+
+/* the device behind the dma task: the page write in flight is applied when it is finished */
+static uint8_t device[EEPROM_SIZE];
+static dma_request_event_t posted;
+static uint32_t posts;
+
+/* called by the load between its reads, with the eeprom lock released */
+static void (*during_load)(uint16_t address) = NULL;
+
+static uint16_t eeprom_test_address(const dma_request_event_t *request)
+{
+    return ((request->address - EEPROM_I2C_ADDRESS) << 8) + request->tx_buffer[0];
+}
+
+dma_response_status dma_transfer(dma_request_event_t *request, dma_response_event_t *response)
+{
+    uint16_t address = eeprom_test_address(request);
+
+    if (during_load != NULL) {
+        during_load(address);
+    }
+    memcpy(request->rx_buffer, &device[address], request->rx_length);
+    response->status = dma_request_status_success;
+    response->length = request->rx_length;
+    return dma_request_status_success;
+}
+
+void dma_post(dma_request_event_t *request)
+{
+    posted = *request;
+    posts++;
+}
+
+/* the dma task completes the page write in flight, returns pdTRUE if the next one is chained */
+static BaseType_t eeprom_test_finish(dma_response_status status)
+{
+    if (status == dma_request_status_success) {
+        memcpy(&device[eeprom_test_address(&posted)], &posted.tx_buffer[1], posted.tx_length - 1);
+    }
+    return posted.complete(&posted, status);
+}
+
+static void eeprom_test_setup()
+{
+    for (uint16_t i = 0; i < EEPROM_SIZE; i++) {
+        device[i] = (uint8_t)(i * 7);
+    }
+    posts = 0;
+    eeprom_init();
+}
+
+static void test_load()
+{
+    uint8_t mirror[EEPROM_SIZE];
+
+    eeprom_test_setup();
+    TEST_EQUAL(eeprom_load(), dma_request_status_success);
+    eeprom_read(0, mirror, sizeof(mirror));
+    TEST_CHECK(memcmp(mirror, device, EEPROM_SIZE) == 0);
+
+    /* outside the device reads as erased */
+    eeprom_read(EEPROM_SIZE - 2, mirror, 4);
+    TEST_EQUAL(mirror[1], device[EEPROM_SIZE - 1]);
+    TEST_EQUAL(mirror[2], 0xFF);
+    TEST_EQUAL(mirror[3], 0xFF);
+}
+
+static void test_combining()
+{
+    uint8_t mirror[48];
+
+    eeprom_test_setup();
+    eeprom_load();
+
+    /* the first write starts page 0, the others are combined while it is in flight */
+    TEST_EQUAL(eeprom_write(3, (const uint8_t *)"abc", 3), dma_request_status_success);
+    TEST_EQUAL(posts, 1);
+    TEST_EQUAL(eeprom_pending(), 1);
+    eeprom_write(5, (const uint8_t *)"de", 2);
+    eeprom_write(18, (const uint8_t *)"f", 1);
+    eeprom_write(30, (const uint8_t *)"ghij", 4);
+    TEST_EQUAL(posts, 1);
+
+    /* page 0 again (written after the snapshot), then pages 1 and 2 */
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdTRUE);
+    TEST_EQUAL(eeprom_test_address(&posted), 0);
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdTRUE);
+    TEST_EQUAL(eeprom_test_address(&posted), 16);
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdTRUE);
+    TEST_EQUAL(eeprom_test_address(&posted), 32);
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdFALSE);
+    TEST_EQUAL(eeprom_pending(), 0);
+
+    eeprom_read(0, mirror, sizeof(mirror));
+    TEST_CHECK(memcmp(&mirror[3], "abde", 4) == 0);
+    TEST_CHECK(memcmp(mirror, device, sizeof(mirror)) == 0);
+}
+
+static void test_retry()
+{
+    uint8_t byte;
+    uint32_t errors;
+
+    eeprom_test_setup();
+    eeprom_load();
+    errors = eeprom_write_errors();
+
+    /* a failed page is retried before the pages that became dirty meanwhile */
+    eeprom_write(100, (const uint8_t *)"k", 1);
+    eeprom_write(20, (const uint8_t *)"l", 1);
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_error), pdTRUE);
+    TEST_EQUAL(eeprom_test_address(&posted), 96);
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdTRUE);
+    TEST_EQUAL(eeprom_test_address(&posted), 16);
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdFALSE);
+    TEST_EQUAL(device[100], 'k');
+    TEST_EQUAL(device[20], 'l');
+    TEST_EQUAL(eeprom_write_errors(), errors);
+
+    /* a page that keeps failing is given up after the retries, the mirror keeps the data */
+    eeprom_write(200, (const uint8_t *)"m", 1);
+    for (uint8_t i = 0; i < EEPROM_WRITE_RETRIES; i++) {
+        TEST_EQUAL(eeprom_test_finish(dma_request_status_error), pdTRUE);
+    }
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_error), pdFALSE);
+    TEST_EQUAL(eeprom_write_errors(), errors + 1);
+    TEST_EQUAL(eeprom_pending(), 0);
+    TEST_CHECK(device[200] != 'm');
+    eeprom_read(200, &byte, 1);
+    TEST_EQUAL(byte, 'm');
+}
+
+/* the load has read the first chunk when it reads the second one */
+static void eeprom_test_write_during_load(uint16_t address)
+{
+    if (address == EEPROM_LOAD_CHUNK) {
+        TEST_EQUAL(eeprom_write(10, (const uint8_t *)"no", 2), dma_request_status_success);
+        TEST_EQUAL(eeprom_write(EEPROM_LOAD_CHUNK, (const uint8_t *)"pq", 2), dma_request_status_error);
+    }
+}
+
+static void test_load_keeps_writes()
+{
+    uint8_t bytes[2];
+
+    /* a write is accepted once its page is loaded */
+    eeprom_test_setup();
+    TEST_EQUAL(eeprom_write(10, (const uint8_t *)"no", 2), dma_request_status_error);
+    during_load = eeprom_test_write_during_load;
+    TEST_EQUAL(eeprom_load(), dma_request_status_success);
+    during_load = NULL;
+    TEST_EQUAL(posts, 1);
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdFALSE);
+    TEST_CHECK(memcmp(&device[10], "no", 2) == 0);
+
+    /* a write in flight (page 4) and a dirty page (5) survive a reload, with their neighbours */
+    eeprom_write(70, (const uint8_t *)"rs", 2);
+    eeprom_write(85, (const uint8_t *)"tu", 2);
+    TEST_EQUAL(eeprom_load(), dma_request_status_success);
+
+    eeprom_read(70, bytes, 2);
+    TEST_CHECK(memcmp(bytes, "rs", 2) == 0);
+    eeprom_read(85, bytes, 2);
+    TEST_CHECK(memcmp(bytes, "tu", 2) == 0);
+
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdTRUE);
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdFALSE);
+    TEST_CHECK(memcmp(&device[70], "rs", 2) == 0);
+    TEST_CHECK(memcmp(&device[85], "tu", 2) == 0);
+    TEST_EQUAL(device[69], (uint8_t)(69 * 7));
+    TEST_EQUAL(device[84], (uint8_t)(84 * 7));
+}
+
+static void test_bounds()
+{
+    const uint8_t bytes[3] = { 1, 2, 3 };
+
+    eeprom_test_setup();
+    eeprom_load();
+    TEST_EQUAL(eeprom_write(EEPROM_SIZE - 2, bytes, 3), dma_request_status_error);
+    TEST_EQUAL(eeprom_write(EEPROM_SIZE, bytes, 1), dma_request_status_error);
+    TEST_EQUAL(eeprom_write(0, bytes, 0), dma_request_status_success);
+    TEST_EQUAL(posts, 0);
+
+    /* the last byte is in the second block */
+    TEST_EQUAL(eeprom_write(EEPROM_SIZE - 1, bytes, 1), dma_request_status_success);
+    TEST_EQUAL(posted.address, EEPROM_I2C_ADDRESS + 1);
+    TEST_EQUAL(eeprom_test_finish(dma_request_status_success), pdFALSE);
+    TEST_EQUAL(device[EEPROM_SIZE - 1], 1);
+}
+
+int main()
+{
+    TEST_RUN(test_load);
+    TEST_RUN(test_combining);
+    TEST_RUN(test_retry);
+    TEST_RUN(test_load_keeps_writes);
+    TEST_RUN(test_bounds);
+    return TEST_RESULT();
+}
@@ -0,0 +1,249 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stdint.h"
+#include "frame.h"
+#include "test.h"
+
+#define PERIOD      20000
+#define BUDGET      10000
+
+/* one frame that takes time us, started as soon as frame_wait allows, returns the end time */
+static uint32_t frame_run(frame_t *frame, uint32_t now, uint32_t time)
+{
+    now += frame_wait(frame, now);
+    frame_begin(frame, now);
+    frame_end(frame, now + time);
+    return now + time;
+}
+
+static void test_stride()
+{
+    frame_t frame;
+    frame_init(&frame, PERIOD, BUDGET);
+
+    TEST_EQUAL(frame_quality(&frame), frame_quality_full);
+    TEST_EQUAL(frame_stride(&frame), 1);
+    frame.quality = frame_quality_reduced;
+    TEST_EQUAL(frame_stride(&frame), 2);
+    frame.quality = frame_quality_minimal;
+    TEST_EQUAL(frame_stride(&frame), 4);
+}
+
+static void test_degrade()
+{
+    frame_t frame;
+    uint32_t now = 1000;
+
+    frame_init(&frame, PERIOD, BUDGET);
+
+    /* a single frame over the budget is tolerated, a good one in between starts the count again */
+    now = frame_run(&frame, now, BUDGET + 1);
+    now = frame_run(&frame, now, BUDGET / 2);
+    now = frame_run(&frame, now, BUDGET + 1);
+    TEST_EQUAL(frame_quality(&frame), frame_quality_full);
+
+    /* FRAME_OVER_LIMIT frames in a row go one level down */
+    now = frame_run(&frame, now, BUDGET + 1);
+    TEST_EQUAL(frame_quality(&frame), frame_quality_reduced);
+    for (uint8_t i = 0; i < FRAME_OVER_LIMIT; i++) {
+        now = frame_run(&frame, now, BUDGET + 1);
+    }
+    TEST_EQUAL(frame_quality(&frame), frame_quality_minimal);
+
+    /* minimal is the floor */
+    for (uint8_t i = 0; i < 2 * FRAME_OVER_LIMIT; i++) {
+        now = frame_run(&frame, now, BUDGET + 1);
+    }
+    TEST_EQUAL(frame_quality(&frame), frame_quality_minimal);
+    TEST_EQUAL(frame.stats.degraded, 2);
+    TEST_EQUAL(frame.stats.over, 3 + 3 * FRAME_OVER_LIMIT);
+    TEST_EQUAL(frame.stats.frames, 4 + 3 * FRAME_OVER_LIMIT);
+    TEST_EQUAL(frame.stats.time_max, BUDGET + 1);
+}
+
+static void test_late()
+{
+    frame_t frame;
+    frame_init(&frame, PERIOD, BUDGET);
+
+    /* within the budget but past the deadline of its slot counts as bad too */
+    frame_begin(&frame, 0);
+    frame_end(&frame, PERIOD + 1);
+    TEST_EQUAL(frame.stats.missed, 1);
+    TEST_EQUAL(frame.stats.over, 1);
+
+    frame_init(&frame, PERIOD, PERIOD * 2);
+    for (uint8_t i = 0; i < FRAME_OVER_LIMIT; i++) {
+        frame_begin(&frame, i * 2 * PERIOD);
+        frame_end(&frame, i * 2 * PERIOD + PERIOD + 1);
+    }
+    TEST_EQUAL(frame.stats.missed, FRAME_OVER_LIMIT);
+    TEST_EQUAL(frame.stats.over, 0);
+    TEST_EQUAL(frame_quality(&frame), frame_quality_reduced);
+}
+
+static void test_recover()
+{
+    frame_t frame;
+    uint32_t now = 0;
+
+    frame_init(&frame, PERIOD, BUDGET);
+    frame.quality = frame_quality_minimal;
+
+    /* frames between half and the full budget hold the quality */
+    for (uint8_t i = 0; i < 2 * FRAME_RECOVER_LIMIT; i++) {
+        now = frame_run(&frame, now, BUDGET / 2 + 1);
+    }
+    TEST_EQUAL(frame_quality(&frame), frame_quality_minimal);
+
+    /* a run of FRAME_RECOVER_LIMIT frames within half the budget goes one level up */
+    for (uint8_t i = 0; i < FRAME_RECOVER_LIMIT - 1; i++) {
+        now = frame_run(&frame, now, BUDGET / 2);
+    }
+    TEST_EQUAL(frame_quality(&frame), frame_quality_minimal);
+    now = frame_run(&frame, now, BUDGET / 2);
+    TEST_EQUAL(frame_quality(&frame), frame_quality_reduced);
+
+    /* a medium frame breaks the run */
+    for (uint8_t i = 0; i < FRAME_RECOVER_LIMIT - 1; i++) {
+        now = frame_run(&frame, now, BUDGET / 2);
+    }
+    now = frame_run(&frame, now, BUDGET / 2 + 1);
+    now = frame_run(&frame, now, BUDGET / 2);
+    TEST_EQUAL(frame_quality(&frame), frame_quality_reduced);
+    for (uint8_t i = 0; i < FRAME_RECOVER_LIMIT - 1; i++) {
+        now = frame_run(&frame, now, BUDGET / 2);
+    }
+    TEST_EQUAL(frame_quality(&frame), frame_quality_full);
+    TEST_EQUAL(frame.stats.degraded, 0);
+}
+
+static void test_slots()
+{
+    frame_t frame;
+    frame_init(&frame, PERIOD, BUDGET);
+
+    /* the first frame starts at once, the next one in the following slot */
+    TEST_EQUAL(frame_wait(&frame, 5000), 0);
+    frame_begin(&frame, 5000);
+    frame_end(&frame, 6000);
+    TEST_EQUAL(frame_wait(&frame, 6000), PERIOD - 1000);
+    TEST_EQUAL(frame_wait(&frame, 5000 + PERIOD), 0);
+
+    /* a frame started a little after its slot keeps the cadence of the slots */
+    frame_begin(&frame, 5000 + PERIOD + 3000);
+    TEST_EQUAL(frame.deadline, 5000 + 2 * PERIOD);
+    frame_end(&frame, 5000 + PERIOD + 4000);
+
+    /* the reduced quality takes two slots per frame and counts the skipped one */
+    frame.quality = frame_quality_reduced;
+    frame_begin(&frame, 5000 + 2 * PERIOD);
+    TEST_EQUAL(frame.deadline, 5000 + 4 * PERIOD);
+    TEST_EQUAL(frame.stats.skipped, 1);
+    frame_end(&frame, 5000 + 2 * PERIOD + 1000);
+    frame.quality = frame_quality_full;
+}
+
+static void test_slot_reset()
+{
+    frame_t frame;
+    frame_init(&frame, PERIOD, BUDGET);
+
+    frame_begin(&frame, 0);
+    frame_end(&frame, 1000);
+
+    /* after an idle time of a period or more the slots start again from the frame */
+    frame_begin(&frame, 3 * PERIOD + 500);
+    TEST_EQUAL(frame.deadline, 4 * PERIOD + 500);
+    frame_end(&frame, 3 * PERIOD + 1500);
+
+    /* the boundary: exactly one period late starts again too */
+    frame_begin(&frame, 5 * PERIOD + 500);
+    TEST_EQUAL(frame.deadline, 6 * PERIOD + 500);
+    frame_end(&frame, 5 * PERIOD + 1500);
+
+    /* a frame started before its slot (frame_wait not honoured) starts the slots from now */
+    frame_begin(&frame, 5 * PERIOD + 2000);
+    TEST_EQUAL(frame.deadline, 6 * PERIOD + 2000);
+    frame_end(&frame, 5 * PERIOD + 3000);
+    TEST_EQUAL(frame.stats.missed, 0);
+}
+
+static void test_wrap()
+{
+    frame_t frame;
+    uint32_t now = 0xFFFFFFFFu - PERIOD / 2;
+
+    frame_init(&frame, PERIOD, BUDGET);
+    frame_begin(&frame, now);
+    frame_end(&frame, now + 1000);
+
+    /* the slot lies past the wrap of the clock */
+    TEST_EQUAL(frame_wait(&frame, now + 1000), PERIOD - 1000);
+    now += PERIOD;
+    TEST_EQUAL(frame_wait(&frame, now), 0);
+    frame_begin(&frame, now);
+    TEST_EQUAL(frame.deadline, now + PERIOD);
+    frame_end(&frame, now + 1000);
+    TEST_EQUAL(frame.stats.missed, 0);
+}
+
+static void test_load()
+{
+    /* a heavy phase of 15ms frames on a 10ms budget, then light frames again: the quality
+       goes down to minimal and comes back to full */
+    frame_t frame;
+    uint32_t now = 0;
+
+    frame_init(&frame, PERIOD, BUDGET);
+    for (uint8_t i = 0; i < 20; i++) {
+        now = frame_run(&frame, now, 15000);
+    }
+    TEST_EQUAL(frame_quality(&frame), frame_quality_minimal);
+    TEST_EQUAL(frame.stats.missed, 0);
+
+    for (uint8_t i = 0; i < 2 * FRAME_RECOVER_LIMIT; i++) {
+        now = frame_run(&frame, now, 2000);
+    }
+    TEST_EQUAL(frame_quality(&frame), frame_quality_full);
+    TEST_EQUAL(frame.stats.degraded, 2);
+    TEST_CHECK(frame.stats.skipped > 0);
+}
+
+int main()
+{
+    TEST_RUN(test_stride);
+    TEST_RUN(test_degrade);
+    TEST_RUN(test_late);
+    TEST_RUN(test_recover);
+    TEST_RUN(test_slots);
+    TEST_RUN(test_slot_reset);
+    TEST_RUN(test_wrap);
+    TEST_RUN(test_load);
+    return TEST_RESULT();
+}
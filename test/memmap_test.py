@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+#______________________________________________________________________________
+#│                                                                            |
+#│ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+#│                                                                            |
+#| Permission is hereby  granted,  free of charge,  to any person obtaining a |
+#| copy of this software and associated documentation files (the "Software"), |
+#| to deal in the Software without restriction,  including without limitation |
+#| the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+#| and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+#| Software is furnished to do so, subject to the following conditions:       |
+#|                                                                            |
+#| The above  copyright notice  and this permission notice  shall be included |
+#| in all copies or substantial portions of the Software.                     |
+#|                                                                            |
+#| THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+#| OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+#| MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+#| IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+#| CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+#| OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+#| THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+#|____________________________________________________________________________|
+#|                                                                            |
+#|  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+#|                                                                            |
+#|____________________________________________________________________________|
+
+# Runs scripts/memmap.py over the linker maps of test/data and checks the ram budget.
+#
+# usage: memmap_test.py
+#
+# The maps are cut down by hand to the parts memmap.py reads, in the layout of the GNU ld map
+# file: memmap.map is built with -fdata-sections, memmap_objects.map without.
+
+import os
+import sys
+import subprocess
+import unittest
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+MEMMAP = os.path.join(HERE, '..', 'scripts', 'memmap.py')
+MAP = os.path.join(HERE, 'data', 'memmap.map')
+OBJECTS = os.path.join(HERE, 'data', 'memmap_objects.map')
+
+
+def run(path, *args):
+    return subprocess.run([sys.executable, MEMMAP] + list(args) + [path], capture_output=True, text=True)
+
+
+def groups(output):
+    # group lines are indented by two, the symbol lines of -v by six
+    result = {}
+    for line in output.splitlines():
+        if line.startswith('  ') and not line.startswith('   ') and not line.startswith('  group'):
+            name, size, _ = line.strip().rsplit(None, 2)
+            result[name] = int(size)
+    return result
+
+
+class MemmapTest(unittest.TestCase):
+    def test_groups(self):
+        self.assertEqual(groups(run(MAP).stdout), {
+            'main stack/heap': 0x600,
+            'task stacks': 0x200 + 0x400,
+            'kernel objects': 0x54 + 0x50,
+            'queues': 0x40,
+            'message pools': 0x100 + 0x40,
+            'framebuffer': 0x2800,
+            'rtos heap': 0x4000,
+            'other': 0x4 + 0xc + 0x4 + 0x8,
+            'used': 30272,
+            'free': 128 * 1024 - 30272,
+        })
+
+    def test_symbols(self):
+        # long names continue on the next line, the numbered suffix of static locals is dropped,
+        # the flash sections and the empty ones are not counted
+        lines = run(MAP, '-v').stdout.splitlines()
+        symbols = [line.split()[0] for line in lines if line.startswith('      ')]
+        self.assertIn('encoder_run_stack', symbols)
+        self.assertIn('counter', symbols)
+        self.assertIn('main.c.o(COMMON)', symbols)
+        self.assertNotIn('font', symbols)
+        self.assertNotIn('unused', symbols)
+
+    def test_ram(self):
+        # the size of the device from the command line wins over the memory configuration
+        self.assertEqual(groups(run(MAP, '--ram', '65536').stdout)['free'], 65536 - 30272)
+
+    def test_data_sections(self):
+        result = run(OBJECTS)
+        self.assertNotEqual(result.returncode, 0)
+        self.assertIn('-fdata-sections', result.stderr)
+        self.assertEqual(result.stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,214 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include <pthread.h>
+#include <time.h>
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "string.h"
+#include "semphr.h"
+#include "gpio.h"
+#include "spi.h"
+#include "system.h"
+#include "st7735.h"
+#include "panel.h"
+#include "rgb444.h"
+#include "test.h"
+
+/* the bytes that went over a bus, with the data/command level of the panel that sent them */
+typedef struct panel_test_wire_t {
+    panel_t *panels[2];
+    uint8_t data[64];
+    uint8_t dc[64];
+    uint16_t length;
+    uint16_t unselected;
+} panel_test_wire_t;
+
+/* output pin levels, a pin is identified by its number */
+static uint8_t panel_test_pins[16];
+
+static panel_test_wire_t wire_a, wire_b;
+static panel_bus_t bus_a = { .spi = (SPI_TypeDef *)&wire_a };
+static panel_bus_t bus_b = { .spi = (SPI_TypeDef *)&wire_b };
+static panel_t panel_a1 = { .bus = &bus_a, .dc = { .pin = 0 }, .res = { .pin = 1 }, .cs = { .pin = 2 } };
+static panel_t panel_a2 = { .bus = &bus_a, .dc = { .pin = 3 }, .res = { .pin = 4 }, .cs = { .pin = 5 } };
+static panel_t panel_b  = { .bus = &bus_b, .dc = { .pin = 6 }, .res = { .pin = 7 }, .cs = { .pin = 8 } };
+
+void gpio_pin_init_output(const gpio_pin_t *pin) { (void)pin; }
+void gpio_pin_high(const gpio_pin_t *pin) { panel_test_pins[pin->pin] = 1; }
+void gpio_pin_low(const gpio_pin_t *pin)  { panel_test_pins[pin->pin] = 0; }
+
+void spi_bus_init(SPI_TypeDef *spi) { (void)spi; }
+uint16_t spi_bus_read(SPI_TypeDef *spi, uint8_t *buffer, uint16_t size) { (void)spi; (void)buffer; return size; }
+void st7735_init(st7735_hw_control_t hw) { (void)hw; }
+void delay_us(const uint32_t us) { (void)us; }
+
+uint16_t spi_bus_write(SPI_TypeDef *spi, const uint8_t *buffer, uint16_t size, uint16_t repeat)
+{
+    panel_test_wire_t *wire = (panel_test_wire_t *)spi;
+    panel_t *selected = NULL;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        if (wire->panels[i] != NULL && panel_test_pins[wire->panels[i]->cs.pin] == 0) {
+            selected = wire->panels[i];
+        }
+    }
+    for (uint16_t j = 0; j < repeat; j++) {
+        for (uint16_t i = 0; i < size && wire->length < sizeof(wire->data); i++) {
+            wire->unselected += (selected == NULL);
+            wire->dc[wire->length] = selected ? panel_test_pins[selected->dc.pin] : 0xFF;
+            wire->data[wire->length++] = buffer[i];
+        }
+    }
+    return size;
+}
+
+static void panel_test_setup()
+{
+    memset(&wire_a, 0, sizeof(wire_a));
+    memset(&wire_b, 0, sizeof(wire_b));
+    wire_a.panels[0] = &panel_a1;
+    wire_a.panels[1] = &panel_a2;
+    wire_b.panels[0] = &panel_b;
+
+    panel_bus_init(&bus_a);
+    panel_bus_init(&bus_b);
+    panel_init(&panel_a1);
+    panel_init(&panel_a2);
+    panel_init(&panel_b);
+}
+
+static void panel_test_teardown()
+{
+    vSemaphoreDelete(bus_a.lock);
+    vSemaphoreDelete(bus_b.lock);
+}
+
+static void panel_test_wire_check(const panel_test_wire_t *wire, const uint8_t *data, const uint8_t *dc, uint16_t length)
+{
+    TEST_EQUAL(wire->length, length);
+    TEST_EQUAL(wire->unselected, 0);
+    TEST_CHECK(memcmp(wire->data, data, length) == 0);
+    TEST_CHECK(memcmp(wire->dc, dc, length) == 0);
+}
+
+static void test_window()
+{
+    const uint8_t pixels[3] = { 0x11, 0x22, 0x33 };
+    const uint8_t data[] = { 0x2B, 0, 10, 0, 30, 0x2A, 0, 20, 0, 40, 0x2C, 0x11, 0x22, 0x33, 0x11, 0x22, 0x33 };
+    const uint8_t dc[]   = { 0,    1, 1,  1, 1,  0,    1, 1,  1, 1,  0,    1,    1,    1,    1,    1,    1    };
+
+    panel_test_setup();
+    panel_begin(&panel_a2);
+    panel_set_window(&panel_a2, 10, 20, 30, 40);
+    panel_memory_write(&panel_a2, pixels, sizeof(pixels), 2);
+    TEST_EQUAL(panel_test_pins[panel_a2.cs.pin], 0);
+    TEST_EQUAL(panel_test_pins[panel_a1.cs.pin], 1);
+    panel_end(&panel_a2);
+
+    panel_test_wire_check(&wire_a, data, dc, sizeof(data));
+    TEST_EQUAL(panel_test_pins[panel_a2.cs.pin], 1);
+    TEST_EQUAL(wire_b.length, 0);
+    panel_test_teardown();
+}
+
+static void test_fill_rgb444()
+{
+    /* three red pixels: one pattern of two pixels and one more that wraps over the first one */
+    const uint8_t red[2] = { 0xF8, 0x00 };
+    const uint8_t data[] = { 0x2B, 0, 5, 0, 7, 0x2A, 0, 9, 0, 9, 0x2C, 0xF0, 0x0F, 0x00, 0xF0, 0x0F, 0x00 };
+    const uint8_t dc[]   = { 0,    1, 1, 1, 1, 0,    1, 1, 1, 1, 0,    1,    1,    1,    1,    1,    1    };
+    st7735_color_16_bit_t color;
+
+    memcpy(&color, red, sizeof(color));
+    panel_test_setup();
+    panel_begin(&panel_b);
+    rgb444_draw_fill(&panel_b, 5, 9, 7, 9, color);
+    panel_end(&panel_b);
+
+    panel_test_wire_check(&wire_b, data, dc, sizeof(data));
+    TEST_EQUAL(wire_a.length, 0);
+    panel_test_teardown();
+}
+
+typedef struct panel_test_thread_t {
+    panel_t *panel;
+    volatile uint8_t done;
+} panel_test_thread_t;
+
+static void *panel_test_thread(void *argument)
+{
+    panel_test_thread_t *thread = argument;
+
+    panel_begin(thread->panel);
+    thread->done = 1;
+    panel_end(thread->panel);
+    return NULL;
+}
+
+/* waits up to ms for the thread to take and release its bus */
+static uint8_t panel_test_wait(const panel_test_thread_t *thread, uint32_t ms)
+{
+    const struct timespec step = { .tv_sec = 0, .tv_nsec = 1000000L };
+
+    for (uint32_t i = 0; i < ms && !thread->done; i++) {
+        nanosleep(&step, NULL);
+    }
+    return thread->done;
+}
+
+static void test_buses()
+{
+    panel_test_thread_t other_bus = { .panel = &panel_b };
+    panel_test_thread_t same_bus = { .panel = &panel_a2 };
+    pthread_t threads[2];
+
+    /* the st7735 driver is bound to a panel of bus a: the frame of the panel on bus b goes
+       through meanwhile, the second panel of bus a waits for its bus */
+    panel_test_setup();
+    panel_driver_bind(&panel_a1);
+    pthread_create(&threads[0], NULL, panel_test_thread, &other_bus);
+    pthread_create(&threads[1], NULL, panel_test_thread, &same_bus);
+
+    TEST_EQUAL(panel_test_wait(&other_bus, 1000), 1);
+    TEST_EQUAL(panel_test_wait(&same_bus, 50), 0);
+
+    panel_driver_release(&panel_a1);
+    TEST_EQUAL(panel_test_wait(&same_bus, 1000), 1);
+
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+    panel_test_teardown();
+}
+
+int main()
+{
+    TEST_RUN(test_window);
+    TEST_RUN(test_fill_rgb444);
+    TEST_RUN(test_buses);
+    return TEST_RESULT();
+}
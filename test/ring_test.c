@@ -0,0 +1,217 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "stm32rtos.h"
+#include "semphr.h"
+#include "ring.h"
+#include "test.h"
+
+/* a lost wake-up leaves the consumer waiting for the whole timeout before it finds the item,
+   the producer never pauses that long */
+#define RING_TEST_TIMEOUT_MS    500
+
+typedef struct ring_test_item_t {
+    uint32_t sequence;
+    uint32_t check;
+} ring_test_item_t;
+
+typedef struct ring_test_t {
+    ring_t ring;
+    uint32_t items;
+    uint32_t full;
+    uint32_t received;
+    uint32_t out_of_order;
+    uint32_t corrupted;
+    uint32_t timeouts;
+    volatile uint8_t stopped;
+} ring_test_t;
+
+static uint32_t ring_test_check(uint32_t sequence)
+{
+    return sequence * 2654435761u;
+}
+
+/* the producer alternates the task and the interrupt entry and retries a full ring, every few
+   items it yields so that the consumer also drains the ring to empty and goes to sleep */
+static void *ring_test_producer(void *argument)
+{
+    ring_test_t *test = argument;
+
+    for (uint32_t i = 0; i < test->items; i++) {
+        ring_test_item_t item = { .sequence = i, .check = ring_test_check(i) };
+
+        for (;;) {
+            BaseType_t woken = pdFALSE;
+            BaseType_t stored = (i & 1) ? ring_put_from_isr(&test->ring, &item, &woken) : ring_put(&test->ring, &item);
+            if (stored == pdTRUE) {
+                break;
+            }
+            test->full++;
+            if (test->stopped) {
+                return NULL;
+            }
+            sched_yield();
+        }
+        if ((i % 97) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *ring_test_consumer(void *argument)
+{
+    ring_test_t *test = argument;
+
+    while (test->received < test->items) {
+        ring_test_item_t item;
+
+        struct timespec start, end;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        BaseType_t received = ring_receive(&test->ring, &item, RING_TEST_TIMEOUT_MS);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        int64_t elapsed_ms = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+        if (received != pdTRUE || elapsed_ms >= RING_TEST_TIMEOUT_MS) {
+            test->timeouts++;
+            break;
+        }
+        if (item.sequence != test->received) {
+            test->out_of_order++;
+        }
+        if (item.check != ring_test_check(item.sequence)) {
+            test->corrupted++;
+        }
+        test->received++;
+    }
+
+    /* a consumer that gave up stops the producer, the ring is no longer drained */
+    test->stopped = 1;
+    return NULL;
+}
+
+static void ring_test_run(uint16_t size, uint32_t items)
+{
+    ring_test_item_t storage[size];
+    ring_test_t test = { .items = items };
+    pthread_t producer, consumer;
+
+    ring_init(&test.ring, storage, sizeof(ring_test_item_t), size);
+    pthread_create(&consumer, NULL, ring_test_consumer, &test);
+    pthread_create(&producer, NULL, ring_test_producer, &test);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    /* deleted once the producer is gone, it may still give the semaphore */
+    vSemaphoreDelete(test.ring.wake);
+
+    TEST_EQUAL(test.received, items);
+    TEST_EQUAL(test.out_of_order, 0);
+    TEST_EQUAL(test.corrupted, 0);
+    TEST_EQUAL(test.timeouts, 0);
+
+    /* every rejected put is counted, nothing else */
+    TEST_EQUAL(test.ring.dropped, test.full);
+    TEST_EQUAL(ring_count(&test.ring), 0);
+
+    printf("  %u items through %u slots: %u puts on a full ring\n", (unsigned)items, (unsigned)size, (unsigned)test.full);
+}
+
+static void test_single()
+{
+    ring_test_item_t storage[4];
+    ring_test_item_t item = { 0 };
+    ring_t ring;
+
+    ring_init(&ring, storage, sizeof(ring_test_item_t), 4);
+    TEST_EQUAL(ring_get(&ring, &item), pdFALSE);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        item.sequence = i;
+        TEST_EQUAL(ring_put(&ring, &item), pdTRUE);
+    }
+    TEST_EQUAL(ring_put(&ring, &item), pdFALSE);
+    TEST_EQUAL(ring.dropped, 1);
+    TEST_EQUAL(ring_count(&ring), 4);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_EQUAL(ring_get(&ring, &item), pdTRUE);
+        TEST_EQUAL(item.sequence, i);
+    }
+    TEST_EQUAL(ring_get(&ring, &item), pdFALSE);
+
+    /* the wake was given by the first put, the stale give only costs one more pass */
+    TEST_EQUAL(ring_receive(&ring, &item, 0), pdFALSE);
+    vSemaphoreDelete(ring.wake);
+}
+
+static void test_wrap()
+{
+    /* the free running 16 bit indexes wrap many times */
+    ring_test_item_t storage[8];
+    ring_test_item_t item = { 0 };
+    ring_t ring;
+    uint32_t failures = 0;
+
+    ring_init(&ring, storage, sizeof(ring_test_item_t), 8);
+    for (uint32_t i = 0; i < 200000; i++) {
+        item.sequence = i;
+        ring_put(&ring, &item);
+        if (i % 3 == 2) {
+            for (uint32_t j = i - 2; j <= i; j++) {
+                failures += (ring_get(&ring, &item) != pdTRUE) || (item.sequence != j);
+            }
+        }
+    }
+    TEST_EQUAL(failures, 0);
+    TEST_EQUAL(ring.dropped, 0);
+    vSemaphoreDelete(ring.wake);
+}
+
+static void test_stress_small()
+{
+    ring_test_run(2, 200000);
+}
+
+static void test_stress_encoder()
+{
+    /* the size of the encoder ring */
+    ring_test_run(8, 200000);
+}
+
+int main()
+{
+    TEST_RUN(test_single);
+    TEST_RUN(test_wrap);
+    TEST_RUN(test_stress_small);
+    TEST_RUN(test_stress_encoder);
+    return TEST_RESULT();
+}
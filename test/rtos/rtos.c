@@ -0,0 +1,125 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include <pthread.h>
+#include "stdlib.h"
+#include "time.h"
+#include "errno.h"
+#include "stm32f4xx.h"
+#include "stm32rtos.h"
+#include "semphr.h"
+
+DWT_Type rtos_dwt;
+
+struct rtos_semaphore_t {
+    pthread_mutex_t lock;
+    pthread_cond_t given;
+    uint32_t count;
+    uint32_t max;
+};
+
+static SemaphoreHandle_t rtos_semaphore_create(uint32_t count)
+{
+    struct rtos_semaphore_t *semaphore = calloc(1, sizeof(struct rtos_semaphore_t));
+
+    pthread_mutex_init(&semaphore->lock, NULL);
+    pthread_cond_init(&semaphore->given, NULL);
+    semaphore->count = count;
+    semaphore->max = 1;
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+    return rtos_semaphore_create(0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return rtos_semaphore_create(1);
+}
+
+/* once no other thread can give the semaphore any more */
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    pthread_cond_destroy(&semaphore->given);
+    pthread_mutex_destroy(&semaphore->lock);
+    free(semaphore);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    BaseType_t given = pdFALSE;
+
+    pthread_mutex_lock(&semaphore->lock);
+    if (semaphore->count < semaphore->max) {
+        semaphore->count++;
+        given = pdTRUE;
+        pthread_cond_signal(&semaphore->given);
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return given;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t *woken)
+{
+    BaseType_t given = xSemaphoreGive(semaphore);
+
+    if (given == pdTRUE && woken != NULL) {
+        *woken = pdTRUE;
+    }
+    return given;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t timeout)
+{
+    struct timespec until;
+    BaseType_t taken = pdFALSE;
+
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_sec += timeout / 1000;
+    until.tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (until.tv_nsec >= 1000000000L) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&semaphore->lock);
+    while (semaphore->count == 0 && timeout > 0) {
+        int error = (timeout == portMAX_DELAY) ? pthread_cond_wait(&semaphore->given, &semaphore->lock)
+                                               : pthread_cond_timedwait(&semaphore->given, &semaphore->lock, &until);
+        if (error == ETIMEDOUT) {
+            break;
+        }
+    }
+    if (semaphore->count > 0) {
+        semaphore->count--;
+        taken = pdTRUE;
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return taken;
+}
@@ -0,0 +1,227 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stdint.h"
+#include "string.h"
+#include "sched.h"
+#include "test.h"
+
+/* devices of the simulated bus */
+#define SENSOR      0x48
+#define EEPROM      0x50
+
+/* simulated bus: the transfers run one after the other, each one takes the time of its bytes
+   at the bus clock, the time only moves forward when a transfer is done or the bus is idle */
+typedef struct bus_t {
+    sched_t sched;
+    uint32_t now;
+} bus_t;
+
+static void bus_init(bus_t *bus, uint32_t bus_hz, uint32_t now)
+{
+    sched_init(&bus->sched, bus_hz);
+    bus->now = now;
+}
+
+/* serves the next transfer, returns its slot or -1 if nothing is queued */
+static int8_t bus_step(bus_t *bus)
+{
+    int8_t slot = sched_pop(&bus->sched, bus->now);
+    if (slot >= 0) {
+        bus->now += bus->sched.slot[slot].cost;
+        sched_done(&bus->sched, slot, bus->now);
+    }
+    return slot;
+}
+
+static void test_transfer_time()
+{
+    /* start, address byte, data and stop: 2 + 9 * (1 + bytes) clocks */
+    TEST_EQUAL(sched_transfer_us(100000, 1), 200);
+    TEST_EQUAL(sched_transfer_us(400000, 1), 50);
+    TEST_EQUAL(sched_transfer_us(100000, 16), 1550);
+    TEST_EQUAL(sched_transfer_us(400000, 16), 388);
+
+    /* the complete eeprom read of eeprom_load, past the 32 bit range of clocks * 1000000 */
+    TEST_EQUAL(sched_transfer_us(100000, 514), 46370);
+    TEST_EQUAL(sched_transfer_us(400000, 514), 11593);
+}
+
+static void test_priority()
+{
+    bus_t bus;
+    bus_init(&bus, 400000, 1000);
+
+    int8_t low = sched_push(&bus.sched, EEPROM, 2, SCHED_NO_DEADLINE, 16, bus.now);
+    int8_t high = sched_push(&bus.sched, SENSOR, 0, SCHED_NO_DEADLINE, 6, bus.now);
+
+    TEST_EQUAL(bus_step(&bus), high);
+    TEST_EQUAL(bus_step(&bus), low);
+    TEST_EQUAL(bus_step(&bus), -1);
+}
+
+static void test_deadline()
+{
+    bus_t bus;
+    bus_init(&bus, 100000, 0);
+
+    /* within a priority the transfers with a deadline go first, the latest start time decides */
+    int8_t none = sched_push(&bus.sched, EEPROM, 1, SCHED_NO_DEADLINE, 4, bus.now);
+    int8_t late = sched_push(&bus.sched, SENSOR, 1, 20000, 4, bus.now);
+    int8_t early = sched_push(&bus.sched, SENSOR, 1, 10000, 4, bus.now);
+
+    /* same deadline as late but 16 bytes longer: it has to start 1440us earlier */
+    int8_t long_late = sched_push(&bus.sched, SENSOR, 1, 20000, 20, bus.now);
+
+    TEST_EQUAL(bus_step(&bus), early);
+    TEST_EQUAL(bus_step(&bus), long_late);
+    TEST_EQUAL(bus_step(&bus), late);
+    TEST_EQUAL(bus_step(&bus), none);
+    TEST_EQUAL(sched_stats(&bus.sched, SENSOR)->deadline_misses, 0);
+}
+
+static void test_fairness()
+{
+    bus_t bus;
+    bus_init(&bus, 400000, 0);
+
+    /* the device served last waits for the other one, whatever the queue order */
+    sched_push(&bus.sched, EEPROM, 1, SCHED_NO_DEADLINE, 8, bus.now);
+    bus_step(&bus);
+
+    int8_t eeprom = sched_push(&bus.sched, EEPROM, 1, SCHED_NO_DEADLINE, 8, bus.now);
+    int8_t sensor = sched_push(&bus.sched, SENSOR, 1, SCHED_NO_DEADLINE, 8, bus.now);
+
+    TEST_EQUAL(bus_step(&bus), sensor);
+    TEST_EQUAL(bus_step(&bus), eeprom);
+}
+
+static void test_aging()
+{
+    bus_t bus;
+    bus_init(&bus, 400000, 0);
+
+    /* a low priority transfer that waited two aging periods competes with priority 0 */
+    int8_t old = sched_push(&bus.sched, EEPROM, 2, SCHED_NO_DEADLINE, 8, bus.now);
+    bus.now += 2 * SCHED_AGING_US;
+    int8_t fresh = sched_push(&bus.sched, SENSOR, 0, SCHED_NO_DEADLINE, 8, bus.now);
+
+    TEST_EQUAL(bus_step(&bus), old);
+    TEST_EQUAL(bus_step(&bus), fresh);
+
+    /* one aging period is not enough */
+    old = sched_push(&bus.sched, EEPROM, 2, SCHED_NO_DEADLINE, 8, bus.now);
+    bus.now += SCHED_AGING_US;
+    fresh = sched_push(&bus.sched, SENSOR, 0, SCHED_NO_DEADLINE, 8, bus.now);
+
+    TEST_EQUAL(bus_step(&bus), fresh);
+    TEST_EQUAL(bus_step(&bus), old);
+}
+
+static void test_full()
+{
+    sched_t sched;
+    sched_init(&sched, 400000);
+
+    for (uint8_t i = 0; i < SCHED_SLOTS; i++) {
+        TEST_CHECK(sched_push(&sched, EEPROM, 1, SCHED_NO_DEADLINE, 1, 0) >= 0);
+    }
+    TEST_CHECK(sched_full(&sched));
+    TEST_EQUAL(sched_queued(&sched), SCHED_SLOTS);
+    TEST_EQUAL(sched_push(&sched, EEPROM, 1, SCHED_NO_DEADLINE, 1, 0), -1);
+}
+
+/* one second of a sensor read every 10ms (6 bytes, priority 0, 2ms deadline) while the eeprom
+   writes pages back to back (16 bytes, priority 2): the bus is never preempted, so a sensor read
+   waits at most for the page on the wire */
+static void simulate(uint32_t bus_hz, sched_stats_t *sensor, sched_stats_t *eeprom)
+{
+    const uint32_t period = 10000;
+    uint32_t release = 0;
+    bus_t bus;
+
+    bus_init(&bus, bus_hz, 0);
+    while (bus.now < 1000000) {
+        /* the reads released while the bus was busy are queued at their release time */
+        while ((int32_t)(bus.now - release) >= 0) {
+            sched_push(&bus.sched, SENSOR, 0, 2000, 6, release);
+            release += period;
+        }
+        /* the eeprom always has the next page waiting */
+        uint8_t pages = 0;
+        for (uint8_t i = 0; i < SCHED_SLOTS; i++) {
+            pages += (bus.sched.slot[i].state == sched_slot_queued) && (bus.sched.slot[i].priority == 2);
+        }
+        if (pages == 0) {
+            sched_push(&bus.sched, EEPROM, 2, SCHED_NO_DEADLINE, 16, bus.now);
+        }
+        bus_step(&bus);
+    }
+
+    *sensor = *sched_stats(&bus.sched, SENSOR);
+    *eeprom = *sched_stats(&bus.sched, EEPROM);
+}
+
+static void test_simulated_bus()
+{
+    sched_stats_t sensor_100k, eeprom_100k, sensor_400k, eeprom_400k;
+
+    simulate(100000, &sensor_100k, &eeprom_100k);
+    simulate(400000, &sensor_400k, &eeprom_400k);
+
+    /* every read is served, none waits longer than one page transfer */
+    TEST_EQUAL(sensor_100k.transfers, 100);
+    TEST_EQUAL(sensor_400k.transfers, 100);
+    TEST_CHECK(sensor_100k.wait_max_us <= sched_transfer_us(100000, 16));
+    TEST_CHECK(sensor_400k.wait_max_us <= sched_transfer_us(400000, 16));
+
+    /* at 400kHz a page and a read fit in the deadline, at 100kHz they do not */
+    TEST_EQUAL(sensor_400k.deadline_misses, 0);
+    TEST_CHECK(sched_transfer_us(100000, 16) + sched_transfer_us(100000, 6) > 2000);
+
+    /* the bus is never idle, the eeprom gets the rest: about 4 times the bytes at 400kHz */
+    TEST_EQUAL(sensor_100k.busy_us, 100 * sched_transfer_us(100000, 6));
+    TEST_CHECK(eeprom_400k.bytes > 38 * eeprom_100k.bytes / 10);
+    TEST_CHECK(eeprom_400k.bytes < 42 * eeprom_100k.bytes / 10);
+
+    printf("  100kHz: sensor wait max %u us, %u misses, eeprom %u bytes/s\n",
+           (unsigned)sensor_100k.wait_max_us, (unsigned)sensor_100k.deadline_misses, (unsigned)eeprom_100k.bytes);
+    printf("  400kHz: sensor wait max %u us, %u misses, eeprom %u bytes/s\n",
+           (unsigned)sensor_400k.wait_max_us, (unsigned)sensor_400k.deadline_misses, (unsigned)eeprom_400k.bytes);
+}
+
+int main()
+{
+    TEST_RUN(test_transfer_time);
+    TEST_RUN(test_priority);
+    TEST_RUN(test_deadline);
+    TEST_RUN(test_fairness);
+    TEST_RUN(test_aging);
+    TEST_RUN(test_full);
+    TEST_RUN(test_simulated_bus);
+    return TEST_RESULT();
+}
@@ -0,0 +1,59 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#pragma once
+
+#include <stdio.h>
+
+/* host test helpers: a failed check is printed and counted, the test goes on */
+static int test_failures = 0;
+
+#define TEST_CHECK(cond)                                                                    \
+    do {                                                                                    \
+        if (!(cond)) {                                                                      \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                 \
+            test_failures++;                                                                \
+        }                                                                                   \
+    } while (0)
+
+#define TEST_EQUAL(actual, expected)                                                        \
+    do {                                                                                    \
+        long long a_ = (long long)(actual), e_ = (long long)(expected);                     \
+        if (a_ != e_) {                                                                     \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+            test_failures++;                                                                \
+        }                                                                                   \
+    } while (0)
+
+#define TEST_RUN(test)                                                                      \
+    do {                                                                                    \
+        int before_ = test_failures;                                                        \
+        test();                                                                             \
+        printf("%-40s %s\n", #test, (test_failures == before_) ? "ok" : "FAILED");          \
+    } while (0)
+
+#define TEST_RESULT()   (test_failures ? 1 : 0)
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+#______________________________________________________________________________
+#│                                                                            |
+#│ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+#│                                                                            |
+#| Permission is hereby  granted,  free of charge,  to any person obtaining a |
+#| copy of this software and associated documentation files (the "Software"), |
+#| to deal in the Software without restriction,  including without limitation |
+#| the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+#| and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+#| Software is furnished to do so, subject to the following conditions:       |
+#|                                                                            |
+#| The above  copyright notice  and this permission notice  shall be included |
+#| in all copies or substantial portions of the Software.                     |
+#|                                                                            |
+#| THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+#| OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+#| MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+#| IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+#| CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+#| OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+#| THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+#|____________________________________________________________________________|
+#|                                                                            |
+#|  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+#|                                                                            |
+#|____________________________________________________________________________|
+
+# Decodes the SWO capture of test/data with scripts/trace.py and checks the Chrome trace JSON.
+#
+# usage: trace_test.py
+#
+# The capture is synthetic, built from the records listed in data/trace_swo.txt in the ITM
+# packet format of trace.c, not recorded from the board.
+
+import os
+import sys
+import json
+import subprocess
+import unittest
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TRACE = os.path.join(HERE, '..', 'scripts', 'trace.py')
+CAPTURE = os.path.join(HERE, 'data', 'trace_swo.bin')
+
+
+def run(*args):
+    return subprocess.run([sys.executable, TRACE] + list(args) + [CAPTURE], check=True, capture_output=True, text=True).stdout
+
+
+class TraceTest(unittest.TestCase):
+    def setUp(self):
+        self.trace = json.loads(run())
+        self.events = [e for e in self.trace['traceEvents'] if e['cat'] != 'log']
+        self.logs = [e for e in self.trace['traceEvents'] if e['cat'] == 'log']
+
+    def test_records(self):
+        # the word without a record header is skipped, sync, overflow and timestamp packets too
+        names = [(e['name'], e['ph']) for e in self.events]
+        self.assertEqual(names, [
+            ('rows', 'B'), ('spi1', 'B'), ('spi1', 'E'), ('rows', 'E'),
+            ('records lost', 'i'), ('queue send dma', 'i'), ('dma complete', 'i'), ('queue receive encoder', 'i'),
+        ])
+
+    def test_arguments(self):
+        self.assertEqual(self.events[1]['args'], {'bytes': 2048})
+        self.assertEqual(self.events[4]['args'], {'records': 3})
+        self.assertEqual(self.events[5]['args'], {'type': 2})
+        self.assertEqual(self.events[6]['args'], {'id': 7, 'status': 0})
+
+    def test_time(self):
+        # 96MHz: 96000 cycles are 1ms
+        self.assertAlmostEqual(self.events[0]['ts'], 1000.0)
+        self.assertAlmostEqual(self.events[2]['ts'], 2000.0)
+
+        # the cycle counter wraps between the queue send and the dma complete
+        stamps = [e['ts'] for e in self.events]
+        self.assertEqual(stamps, sorted(stamps))
+        self.assertAlmostEqual(self.events[6]['ts'] - self.events[5]['ts'], 0x200 / 96.0)
+
+    def test_clock(self):
+        trace = json.loads(run('--clock', '48e6'))
+        self.assertAlmostEqual(trace['traceEvents'][0]['ts'], 2000.0)
+
+    def test_log(self):
+        # the text of port 0 sits at the record written before it
+        self.assertEqual([e['name'] for e in self.logs], ['flush'])
+        self.assertAlmostEqual(self.logs[0]['ts'], self.events[1]['ts'])
+
+    def test_text(self):
+        lines = run('--text').splitlines()
+        self.assertEqual(len(lines), len(self.events))
+        self.assertIn('records lost records=3', lines[4])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,224 @@
+/*_____________________________________________________________________________
+ │                                                                            |
+ │ COPYRIGHT (C) 2026 Mihai Baneu                                             |
+ │                                                                            |
+ | Permission is hereby  granted,  free of charge,  to any person obtaining a |
+ | copy of this software and associated documentation files (the "Software"), |
+ | to deal in the Software without restriction,  including without limitation |
+ | the rights to  use, copy, modify, merge, publish, distribute,  sublicense, |
+ | and/or sell copies  of  the Software, and to permit  persons to  whom  the |
+ | Software is furnished to do so, subject to the following conditions:       |
+ |                                                                            |
+ | The above  copyright notice  and this permission notice  shall be included |
+ | in all copies or substantial portions of the Software.                     |
+ |                                                                            |
+ | THE SOFTWARE IS PROVIDED  "AS IS",  WITHOUT WARRANTY OF ANY KIND,  EXPRESS |
+ | OR   IMPLIED,   INCLUDING   BUT   NOT   LIMITED   TO   THE  WARRANTIES  OF |
+ | MERCHANTABILITY,  FITNESS FOR  A  PARTICULAR  PURPOSE AND NONINFRINGEMENT. |
+ | IN NO  EVENT SHALL  THE AUTHORS  OR  COPYRIGHT  HOLDERS  BE LIABLE FOR ANY |
+ | CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER IN AN ACTION OF CONTRACT, TORT |
+ | OR OTHERWISE, ARISING FROM,  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  |
+ | THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                 |
+ |____________________________________________________________________________|
+ |                                                                            |
+ |  Author: Mihai Baneu                           Last modified: 18.Oct.2026  |
+ |                                                                            |
+ |___________________________________________________________________________*/
+
+#include "stdint.h"
+#include "stdlib.h"
+#include "string.h"
+#include "update.h"
+#include "test.h"
+
+/* the display of the tests: a window of UPDATE_ROWS numbered lines, the text of line n is "line n" */
+typedef struct screen_t {
+    char display_txt[UPDATE_ROWS][UPDATE_ROW_SIZE];
+    uint8_t top;
+    int32_t first;
+} screen_t;
+
+static void line_txt(char *txt, int32_t line)
+{
+    snprintf(txt, UPDATE_ROW_SIZE, "line %ld", (long)line);
+}
+
+static void post_rows(update_t *update, int32_t first)
+{
+    char rows_txt[UPDATE_ROWS][UPDATE_ROW_SIZE];
+
+    for (uint8_t i = 0; i < UPDATE_ROWS; i++) {
+        line_txt(rows_txt[i], first + i);
+    }
+    update_rows(update, rows_txt);
+}
+
+static void post_scroll(update_t *update, int8_t direction, int32_t *first)
+{
+    char txt[UPDATE_ROW_SIZE];
+
+    *first += direction;
+    line_txt(txt, (direction > 0) ? *first + UPDATE_ROWS - 1 : *first);
+    update_scroll(update, direction, txt);
+}
+
+/* applies the update and checks the screen shows the lines from first on, returns the changed mask */
+static uint8_t apply(screen_t *screen, const update_t *update, int32_t first)
+{
+    char expected[UPDATE_ROWS][UPDATE_ROW_SIZE];
+    uint8_t expected_changed = 0;
+
+    for (uint8_t i = 0; i < UPDATE_ROWS; i++) {
+        line_txt(expected[i], first + i);
+        if (strcmp(expected[i], screen->display_txt[(screen->top + i) % UPDATE_ROWS]) != 0) {
+            expected_changed |= 1 << i;
+        }
+    }
+
+    uint8_t changed = update_apply(update, screen->display_txt, &screen->top);
+    for (uint8_t i = 0; i < UPDATE_ROWS; i++) {
+        TEST_CHECK(strcmp(screen->display_txt[(screen->top + i) % UPDATE_ROWS], expected[i]) == 0);
+    }
+    TEST_EQUAL(changed, expected_changed);
+    screen->first = first;
+    return changed;
+}
+
+static void screen_init(screen_t *screen, int32_t first)
+{
+    update_t update;
+
+    memset(screen, 0, sizeof(screen_t));
+    update_clear(&update);
+    post_rows(&update, first);
+    TEST_EQUAL(apply(screen, &update, first), UPDATE_ALL_ROWS);
+}
+
+static void test_rows()
+{
+    screen_t screen;
+    update_t update;
+
+    screen_init(&screen, 100);
+
+    /* the same rows again change nothing */
+    update_clear(&update);
+    post_rows(&update, 100);
+    TEST_EQUAL(apply(&screen, &update, 100), 0);
+    TEST_EQUAL(update.posted, 1);
+}
+
+static void test_scroll()
+{
+    screen_t screen;
+    update_t update;
+    int32_t first = 100;
+
+    screen_init(&screen, first);
+
+    /* one row up: every position shows another line, the display ring only moves its top */
+    update_clear(&update);
+    post_scroll(&update, 1, &first);
+    TEST_EQUAL(update.rows, 1 << (UPDATE_ROWS - 1));
+    TEST_EQUAL(apply(&screen, &update, first), UPDATE_ALL_ROWS);
+    TEST_EQUAL(screen.top, 1);
+
+    /* one row down brings the line at the top back */
+    update_clear(&update);
+    post_scroll(&update, -1, &first);
+    TEST_EQUAL(update.rows, 1);
+    TEST_EQUAL(apply(&screen, &update, first), UPDATE_ALL_ROWS);
+    TEST_EQUAL(screen.top, 0);
+}
+
+static void test_merge()
+{
+    screen_t screen;
+    update_t update;
+    int32_t first = 100;
+
+    screen_init(&screen, first);
+
+    /* three scrolls while the display is busy become one update of net scroll 3 */
+    update_clear(&update);
+    for (uint8_t i = 0; i < 3; i++) {
+        post_scroll(&update, 1, &first);
+    }
+    TEST_EQUAL(update.scroll, 3);
+    TEST_EQUAL(update.posted, 3);
+    apply(&screen, &update, first);
+
+    /* up and down cancel, nothing changes on the screen */
+    update_clear(&update);
+    post_scroll(&update, 1, &first);
+    post_scroll(&update, -1, &first);
+    TEST_EQUAL(update.scroll, 0);
+    TEST_EQUAL(apply(&screen, &update, first), 0);
+
+    /* more scrolls than rows replace the whole screen */
+    update_clear(&update);
+    for (uint8_t i = 0; i < 2 * UPDATE_ROWS + 1; i++) {
+        post_scroll(&update, -1, &first);
+    }
+    TEST_EQUAL(update.rows, UPDATE_ALL_ROWS);
+    apply(&screen, &update, first);
+
+    /* a jump drops the scrolls posted before it, the scrolls after it still apply */
+    update_clear(&update);
+    post_scroll(&update, 1, &first);
+    first = 500;
+    post_rows(&update, first);
+    post_scroll(&update, 1, &first);
+    post_scroll(&update, 1, &first);
+    apply(&screen, &update, first);
+}
+
+static void test_background()
+{
+    update_t update;
+
+    update_clear(&update);
+    update_background(&update);
+    update_background(&update);
+    TEST_EQUAL(update.background, 2);
+    TEST_EQUAL(update.rows, 0);
+    TEST_EQUAL(update.posted, 2);
+}
+
+static void test_random()
+{
+    /* random bursts of scrolls and jumps, merged and applied at once, always show the window */
+    screen_t screen;
+    update_t update;
+    int32_t first = 1000;
+    int failures = test_failures;
+
+    srand(1);
+    screen_init(&screen, first);
+    for (uint16_t burst = 0; burst < 2000 && test_failures == failures; burst++) {
+        uint8_t posts = 1 + rand() % 12;
+
+        update_clear(&update);
+        for (uint8_t i = 0; i < posts; i++) {
+            int choice = rand() % 16;
+            if (choice == 0) {
+                first = 1000 + rand() % 1000;
+                post_rows(&update, first);
+            }
+            else {
+                post_scroll(&update, (choice & 1) ? 1 : -1, &first);
+            }
+        }
+        apply(&screen, &update, first);
+    }
+}
+
+int main()
+{
+    TEST_RUN(test_rows);
+    TEST_RUN(test_scroll);
+    TEST_RUN(test_merge);
+    TEST_RUN(test_background);
+    TEST_RUN(test_random);
+    return TEST_RESULT();
+}